@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#include "DynamicArray.hpp"
+
+// Bit-packed companion of DynamicArray<bool>, 64 flags per word.
+// Range modifiers, count and bulk AND/OR/XOR work a word at a time in plain
+// loops the compiler can vectorize. Bits past size() in the last word are
+// always kept zero.
+
+template<typename Allocator = Allocator<uint64_t>>
+class BitArray
+{
+public:
+    using word_type  = uint64_t;
+    using size_type  = size_t;
+    using array_type = DynamicArray<word_type, Allocator>;
+    using allocator  = Allocator;
+
+    static constexpr size_type wordBits = 64;
+
+    class reference
+    {
+    public:
+        reference(word_type* word, const word_type mask) noexcept : _word(word), _mask(mask) {}
+
+        operator bool() const noexcept { return (*_word & _mask) != 0; }
+        reference& operator=(const bool val) noexcept {
+            *_word = val ? *_word | _mask : *_word & ~_mask;
+            return *this;
+        }
+        reference& operator=(const reference& ref) noexcept { return *this = static_cast<bool>(ref); }
+        void flip() noexcept { *_word ^= _mask; }
+
+    private:
+        word_type* _word;
+        word_type _mask;
+    };
+
+    // Constructors
+    BitArray() noexcept : _size(0) {}
+    explicit BitArray(const size_type size, const bool val = false);
+    BitArray(const BitArray& ba) = default;
+    BitArray(BitArray&& ba) noexcept;
+    BitArray& operator=(const BitArray& ba) = default;
+    BitArray& operator=(BitArray&& ba) noexcept;
+
+    // Element access
+    bool test(const size_type key) const noexcept { return (_words[key / wordBits] >> (key % wordBits)) & 1; }
+    bool operator[](const size_type key) const noexcept { return test(key); }
+    reference operator[](const size_type key) noexcept { return {_words.data() + key / wordBits, bit(key)}; }
+    bool at(const size_type key) const;
+    const word_type* data() const noexcept { return _words.data(); }
+
+    // Single bit modifiers
+    void set(const size_type key) noexcept { _words[key / wordBits] |= bit(key); }
+    void reset(const size_type key) noexcept { _words[key / wordBits] &= ~bit(key); }
+    void flip(const size_type key) noexcept { _words[key / wordBits] ^= bit(key); }
+
+    // Range modifiers over [first, last)
+    void set(const size_type first, const size_type last) noexcept;
+    void reset(const size_type first, const size_type last) noexcept;
+    void flip(const size_type first, const size_type last) noexcept;
+    void set() noexcept { set(0, _size); }
+    void reset() noexcept { reset(0, _size); }
+    void flip() noexcept { flip(0, _size); }
+
+    // Size modifiers
+    void push_back(const bool val);
+    void resize(const size_type newSize);
+    void reserve(const size_type bits) { _words.reserve(wordsFor(bits)); }
+    void clear() noexcept;
+
+    // Queries, find_* return size() if there is no set bit
+    size_type count() const noexcept;
+    bool any() const noexcept;
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == _size; }
+    size_type find_first() const noexcept { return findFrom(0); }
+    size_type find_next(const size_type pos) const noexcept { return findFrom(pos + 1); }
+
+    // Info
+    inline size_type size() const { return _size; }
+    inline size_type words() const { return _words.size(); }
+    inline bool empty() const { return _size == 0; }
+
+    // Bulk operations, both operands must have the same size
+    BitArray& operator&=(const BitArray& rhs);
+    BitArray& operator|=(const BitArray& rhs);
+    BitArray& operator^=(const BitArray& rhs);
+
+private:
+    static word_type bit(const size_type key) noexcept { return word_type(1) << (key % wordBits); }
+    static size_type wordsFor(const size_type size) noexcept { return (size + wordBits - 1) / wordBits; }
+
+    template<typename Op> void applyRange(const size_type first, const size_type last, Op op) noexcept;
+    template<typename Op> BitArray& applyWords(const BitArray& rhs, Op op);
+    void clearTail() noexcept;
+    size_type findFrom(const size_type pos) const noexcept;
+
+    array_type _words;
+    size_type _size;
+};
+
+template<typename Allocator>
+BitArray<Allocator>::BitArray(const size_type size, const bool val) :
+    _words(wordsFor(size)), _size(size) {
+    if (val) {
+        set();
+    }
+}
+
+template<typename Allocator>
+bool BitArray<Allocator>::at(const size_type key) const {
+    if (key >= _size) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return test(key);
+}
+
+template<typename Allocator>
+void BitArray<Allocator>::set(const size_type first, const size_type last) noexcept {
+    applyRange(first, last, [](word_type& w, const word_type mask) { w |= mask; });
+}
+
+template<typename Allocator>
+void BitArray<Allocator>::reset(const size_type first, const size_type last) noexcept {
+    applyRange(first, last, [](word_type& w, const word_type mask) { w &= ~mask; });
+}
+
+template<typename Allocator>
+void BitArray<Allocator>::flip(const size_type first, const size_type last) noexcept {
+    applyRange(first, last, [](word_type& w, const word_type mask) { w ^= mask; });
+}
+
+template<typename Allocator>
+BitArray<Allocator>::BitArray(BitArray&& ba) noexcept :
+    _words(std::move(ba._words)), _size(ba._size) {
+    ba._size = 0;
+}
+
+template<typename Allocator>
+BitArray<Allocator>& BitArray<Allocator>::operator=(BitArray&& ba) noexcept {
+    if (this == &ba) {
+        return *this;
+    }
+
+    _words = std::move(ba._words);
+    _size = ba._size;
+    ba._size = 0;
+
+    return *this;
+}
+
+// The word array grows geometrically here, DynamicArray alone would add a
+// fixed number of words per reallocation
+template<typename Allocator>
+void BitArray<Allocator>::push_back(const bool val) {
+    if (_size % wordBits == 0) {
+        if (_words.size() == _words.capacity()) {
+            _words.reserve(std::max<size_type>(10, 2 * _words.capacity()));
+        }
+        _words.push_back(0);
+    }
+
+    (*this)[_size++] = val;
+}
+
+template<typename Allocator>
+void BitArray<Allocator>::resize(const size_type newSize) {
+    _words.resize(wordsFor(newSize));
+    _size = newSize;
+    clearTail();
+}
+
+template<typename Allocator>
+void BitArray<Allocator>::clear() noexcept {
+    _words.clear();
+    _size = 0;
+}
+
+template<typename Allocator>
+typename BitArray<Allocator>::size_type BitArray<Allocator>::count() const noexcept {
+    size_type n = 0;
+    for (size_type i = 0; i < _words.size(); ++i) {
+        n += static_cast<size_type>(std::popcount(_words[i]));
+    }
+
+    return n;
+}
+
+template<typename Allocator>
+bool BitArray<Allocator>::any() const noexcept {
+    for (size_type i = 0; i < _words.size(); ++i) {
+        if (_words[i] != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename Allocator>
+BitArray<Allocator>& BitArray<Allocator>::operator&=(const BitArray& rhs) {
+    return applyWords(rhs, [](word_type& w, const word_type r) { w &= r; });
+}
+
+template<typename Allocator>
+BitArray<Allocator>& BitArray<Allocator>::operator|=(const BitArray& rhs) {
+    return applyWords(rhs, [](word_type& w, const word_type r) { w |= r; });
+}
+
+template<typename Allocator>
+BitArray<Allocator>& BitArray<Allocator>::operator^=(const BitArray& rhs) {
+    return applyWords(rhs, [](word_type& w, const word_type r) { w ^= r; });
+}
+
+template<typename A>
+BitArray<A> operator&(BitArray<A> lhs, const BitArray<A>& rhs) {
+    lhs &= rhs;
+    return lhs;
+}
+
+template<typename A>
+BitArray<A> operator|(BitArray<A> lhs, const BitArray<A>& rhs) {
+    lhs |= rhs;
+    return lhs;
+}
+
+template<typename A>
+BitArray<A> operator^(BitArray<A> lhs, const BitArray<A>& rhs) {
+    lhs ^= rhs;
+    return lhs;
+}
+
+template<typename A>
+bool operator==(const BitArray<A>& lhs, const BitArray<A>& rhs) noexcept {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    using size_type = typename BitArray<A>::size_type;
+    for (size_type i = 0; i < lhs.words(); ++i) {
+        if (lhs.data()[i] != rhs.data()[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Allocator>
+template<typename Op>
+void BitArray<Allocator>::applyRange(const size_type first, const size_type last, Op op) noexcept {
+    if (first >= last) {
+        return;
+    }
+
+    word_type* w = _words.data();
+    const size_type firstWord = first / wordBits;
+    const size_type lastWord = (last - 1) / wordBits;
+    const word_type firstMask = ~word_type(0) << (first % wordBits);
+    const word_type lastMask = ~word_type(0) >> (wordBits - 1 - (last - 1) % wordBits);
+
+    if (firstWord == lastWord) {
+        op(w[firstWord], firstMask & lastMask);
+        return;
+    }
+
+    op(w[firstWord], firstMask);
+    for (size_type i = firstWord + 1; i < lastWord; ++i) {
+        op(w[i], ~word_type(0));
+    }
+    op(w[lastWord], lastMask);
+}
+
+template<typename Allocator>
+template<typename Op>
+BitArray<Allocator>& BitArray<Allocator>::applyWords(const BitArray& rhs, Op op) {
+    if (_size != rhs._size) {
+        throw std::invalid_argument("bit arrays differ in size");
+    }
+
+    word_type* w = _words.data();
+    const word_type* r = rhs._words.data();
+    for (size_type i = 0; i < _words.size(); ++i) {
+        op(w[i], r[i]);
+    }
+
+    return *this;
+}
+
+template<typename Allocator>
+void BitArray<Allocator>::clearTail() noexcept {
+    if (_size % wordBits != 0) {
+        _words[_size / wordBits] &= ~(~word_type(0) << (_size % wordBits));
+    }
+}
+
+template<typename Allocator>
+typename BitArray<Allocator>::size_type
+BitArray<Allocator>::findFrom(const size_type pos) const noexcept {
+    if (pos >= _size) {
+        return _size;
+    }
+
+    size_type i = pos / wordBits;
+    word_type w = _words[i] & (~word_type(0) << (pos % wordBits));
+    while (w == 0) {
+        if (++i == _words.size()) {
+            return _size;
+        }
+        w = _words[i];
+    }
+
+    return i * wordBits + static_cast<size_type>(std::countr_zero(w));
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DynamicArray.hpp"
+
+// Read-only compressed copy of an integral DynamicArray.
+// Values are split into blocks of blockSize. Each block is bit-packed either
+// as offsets from its minimum (frame of reference) or as deltas between
+// neighbours offset by the smallest delta, whichever is narrower, so sorted
+// and low-entropy columns shrink the most. Every block starts on a word
+// boundary and has its own header, so element access decodes one block at
+// most and iteration decodes on the fly.
+
+template<std::integral T>
+class CompressedIntArray
+{
+public:
+    using value_type = T;
+    using size_type  = size_t;
+    using word_type  = uint64_t;
+
+    static constexpr size_type blockSize = 128;
+    static constexpr size_type wordBits = 64;
+
+    class const_iterator
+    {
+    public:
+        const_iterator() : _a(nullptr), _index(0), _value(0) {}
+
+        T operator*() const { return static_cast<T>(_value); }
+
+        const_iterator& operator++() {
+            if (++_index < _a->_size) {
+                const BlockHeader& h = _a->_headers[_index / blockSize];
+                _value = _a->decode(h, _index % blockSize, _value);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator prev(*this);
+            ++*this;
+            return prev;
+        }
+
+        bool operator==(const const_iterator& it) const { return _index == it._index; }
+
+    private:
+        friend class CompressedIntArray;
+
+        const_iterator(const CompressedIntArray* a, const size_type index) :
+            _a(a), _index(index), _value(0) {
+            if (_index < _a->_size) {
+                _value = _a->decode(_a->_headers[0], 0, 0);
+            }
+        }
+
+        const CompressedIntArray* _a;
+        size_type _index;
+        std::make_unsigned_t<T> _value;
+    };
+
+    // Constructors
+    CompressedIntArray() noexcept : _size(0) {}
+    template<typename A>
+    explicit CompressedIntArray(const DynamicArray<T, A>& da);
+
+    // Element access, decodes up to one block
+    T operator[](const size_type key) const;
+    T at(const size_type key) const;
+
+    // Writes the block values to out, which must hold blockSize elements.
+    // Returns the number of values written.
+    size_type decodeBlock(const size_type block, T* out) const;
+    DynamicArray<T> decompress() const;
+
+    // Info
+    inline size_type size() const { return _size; }
+    inline bool empty() const { return _size == 0; }
+    inline size_type blocks() const { return _headers.size(); }
+    size_type bytes() const;
+
+    // Iterators
+    const_iterator cbegin() const { return const_iterator(this, 0); }
+    const_iterator cend() const { return const_iterator(this, _size); }
+
+private:
+    using U = std::make_unsigned_t<T>;
+    using S = std::make_signed_t<T>;
+
+    struct BlockHeader
+    {
+        U base;
+        U deltaMin;
+        size_type wordOffset;
+        uint8_t width;
+        bool delta;
+    };
+
+    static BlockHeader encodeHeader(const T* values, const size_type n);
+    static word_type read(const word_type* words, const size_type bitPos, const uint8_t width) noexcept;
+    static void write(word_type* words, const size_type bitPos, const word_type val, const uint8_t width) noexcept;
+
+    // Value of element i of a block given the value of element i - 1
+    U decode(const BlockHeader& h, const size_type i, const U prev) const noexcept;
+    size_type blockLength(const size_type block) const noexcept;
+
+    DynamicArray<BlockHeader> _headers;
+    DynamicArray<word_type> _words;
+    size_type _size;
+};
+
+template<std::integral T>
+template<typename A>
+CompressedIntArray<T>::CompressedIntArray(const DynamicArray<T, A>& da) : _size(da.size()) {
+    const T* values = da.data();
+    const size_type blockCount = (_size + blockSize - 1) / blockSize;
+
+    // First pass picks the encoding of every block to size the packed words
+    _headers.reserve(blockCount);
+    size_type wordCount = 0;
+    for (size_type b = 0; b < blockCount; ++b) {
+        BlockHeader h = encodeHeader(values + b * blockSize, blockLength(b));
+        h.wordOffset = wordCount;
+        wordCount += (blockLength(b) * h.width + wordBits - 1) / wordBits;
+        _headers.push_back(h);
+    }
+
+    _words = DynamicArray<word_type>(wordCount);
+    word_type* words = _words.data();
+    for (size_type b = 0; b < blockCount; ++b) {
+        const BlockHeader& h = _headers[b];
+        const T* block = values + b * blockSize;
+        const size_type bitPos = h.wordOffset * wordBits;
+
+        if (h.delta) {
+            for (size_type i = 1; i < blockLength(b); ++i) {
+                U d = static_cast<U>(static_cast<U>(block[i]) - static_cast<U>(block[i - 1]) - h.deltaMin);
+                write(words, bitPos + (i - 1) * h.width, d, h.width);
+            }
+        } else {
+            for (size_type i = 0; i < blockLength(b); ++i) {
+                U d = static_cast<U>(static_cast<U>(block[i]) - h.base);
+                write(words, bitPos + i * h.width, d, h.width);
+            }
+        }
+    }
+}
+
+template<std::integral T>
+T CompressedIntArray<T>::operator[](const size_type key) const {
+    const BlockHeader& h = _headers[key / blockSize];
+    const size_type pos = key % blockSize;
+    if (!h.delta) {
+        return static_cast<T>(decode(h, pos, 0));
+    }
+
+    U val = h.base;
+    for (size_type i = 1; i <= pos; ++i) {
+        val = decode(h, i, val);
+    }
+
+    return static_cast<T>(val);
+}
+
+template<std::integral T>
+T CompressedIntArray<T>::at(const size_type key) const {
+    if (key >= _size) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return (*this)[key];
+}
+
+template<std::integral T>
+typename CompressedIntArray<T>::size_type
+CompressedIntArray<T>::decodeBlock(const size_type block, T* out) const {
+    const BlockHeader& h = _headers[block];
+    const size_type n = blockLength(block);
+
+    if (h.delta) {
+        U val = h.base;
+        out[0] = static_cast<T>(val);
+        for (size_type i = 1; i < n; ++i) {
+            val = decode(h, i, val);
+            out[i] = static_cast<T>(val);
+        }
+    } else {
+        for (size_type i = 0; i < n; ++i) {
+            out[i] = static_cast<T>(decode(h, i, 0));
+        }
+    }
+
+    return n;
+}
+
+template<std::integral T>
+DynamicArray<T> CompressedIntArray<T>::decompress() const {
+    DynamicArray<T> da(_size);
+    for (size_type b = 0; b < blocks(); ++b) {
+        decodeBlock(b, da.data() + b * blockSize);
+    }
+
+    return da;
+}
+
+template<std::integral T>
+typename CompressedIntArray<T>::size_type CompressedIntArray<T>::bytes() const {
+    return _headers.size() * sizeof(BlockHeader) + _words.size() * sizeof(word_type);
+}
+
+template<std::integral T>
+typename CompressedIntArray<T>::BlockHeader
+CompressedIntArray<T>::encodeHeader(const T* values, const size_type n) {
+    T min = values[0];
+    for (size_type i = 1; i < n; ++i) {
+        min = values[i] < min ? values[i] : min;
+    }
+
+    U forBits = 0;
+    for (size_type i = 0; i < n; ++i) {
+        forBits |= static_cast<U>(static_cast<U>(values[i]) - static_cast<U>(min));
+    }
+
+    // Deltas are taken modulo 2^N, so the smallest one is chosen as signed
+    // to keep runs of ascending and descending values narrow
+    S deltaMin = 0;
+    for (size_type i = 1; i < n; ++i) {
+        S d = static_cast<S>(static_cast<U>(static_cast<U>(values[i]) - static_cast<U>(values[i - 1])));
+        deltaMin = (i == 1 || d < deltaMin) ? d : deltaMin;
+    }
+
+    U deltaBits = 0;
+    for (size_type i = 1; i < n; ++i) {
+        U d = static_cast<U>(static_cast<U>(values[i]) - static_cast<U>(values[i - 1]));
+        deltaBits |= static_cast<U>(d - static_cast<U>(deltaMin));
+    }
+
+    const auto forWidth = static_cast<uint8_t>(std::bit_width(forBits));
+    const auto deltaWidth = static_cast<uint8_t>(std::bit_width(deltaBits));
+
+    BlockHeader h{};
+    if ((n - 1) * deltaWidth < n * forWidth) {
+        h.base = static_cast<U>(values[0]);
+        h.deltaMin = static_cast<U>(deltaMin);
+        h.width = deltaWidth;
+        h.delta = true;
+    } else {
+        h.base = static_cast<U>(min);
+        h.width = forWidth;
+        h.delta = false;
+    }
+
+    return h;
+}
+
+template<std::integral T>
+typename CompressedIntArray<T>::word_type
+CompressedIntArray<T>::read(const word_type* words, const size_type bitPos, const uint8_t width) noexcept {
+    if (width == 0) {
+        return 0;
+    }
+
+    const size_type w = bitPos / wordBits;
+    const size_type shift = bitPos % wordBits;
+    word_type val = words[w] >> shift;
+    if (shift + width > wordBits) {
+        val |= words[w + 1] << (wordBits - shift);
+    }
+
+    return width == wordBits ? val : val & ((word_type(1) << width) - 1);
+}
+
+template<std::integral T>
+void CompressedIntArray<T>::write(word_type* words, const size_type bitPos,
+                                  const word_type val, const uint8_t width) noexcept {
+    if (width == 0) {
+        return;
+    }
+
+    const size_type w = bitPos / wordBits;
+    const size_type shift = bitPos % wordBits;
+    words[w] |= val << shift;
+    if (shift + width > wordBits) {
+        words[w + 1] |= val >> (wordBits - shift);
+    }
+}
+
+template<std::integral T>
+typename CompressedIntArray<T>::U
+CompressedIntArray<T>::decode(const BlockHeader& h, const size_type i, const U prev) const noexcept {
+    const word_type* words = _words.data();
+    const size_type bitPos = h.wordOffset * wordBits;
+
+    if (h.delta) {
+        if (i == 0) {
+            return h.base;
+        }
+        return static_cast<U>(prev + h.deltaMin + static_cast<U>(read(words, bitPos + (i - 1) * h.width, h.width)));
+    }
+
+    return static_cast<U>(h.base + static_cast<U>(read(words, bitPos + i * h.width, h.width)));
+}
+
+template<std::integral T>
+typename CompressedIntArray<T>::size_type
+CompressedIntArray<T>::blockLength(const size_type block) const noexcept {
+    const size_type first = block * blockSize;
+    return _size - first < blockSize ? _size - first : blockSize;
+}
@@ -210,7 +210,7 @@ DynamicArray<T, Allocator>::operator=(DynamicArray<T, Allocator>&& da) noexcept
         return *this;
     }
 
-    for (size_type i = 0; i < _size; +i) {
+    for (size_type i = 0; i < _size; ++i) {
         std::destroy_at(_p + i);
     }
     alloc.deallocate(_p, _capacity);
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "DynamicArray.hpp"
+
+// Lazy element-wise arithmetic over numeric DynamicArrays.
+// Operators build a tree of lightweight nodes holding pointers into the
+// operand arrays, evaluate() and evaluateInto() then run one fused loop
+// without temporaries. Operands must outlive the expression.
+//
+// Comparing two plain DynamicArrays keeps its lexicographic meaning, wrap
+// one of them with asExpr() to get an element-wise mask.
+
+template<typename T>
+class ArrayExpr
+{
+public:
+    using expression_tag = void;
+    using value_type     = T;
+
+    static constexpr bool sized = true;
+
+    ArrayExpr(const T* p, const size_t size) noexcept : _p(p), _size(size) {}
+
+    T operator[](const size_t key) const noexcept { return _p[key]; }
+    size_t size() const noexcept { return _size; }
+
+private:
+    const T* _p;
+    size_t _size;
+};
+
+// Scalar broadcast, has no size of its own
+template<typename T>
+class ScalarExpr
+{
+public:
+    using expression_tag = void;
+    using value_type     = T;
+
+    static constexpr bool sized = false;
+
+    explicit ScalarExpr(const T val) noexcept : _val(val) {}
+
+    T operator[](const size_t) const noexcept { return _val; }
+
+private:
+    T _val;
+};
+
+template<typename E>
+concept Expression = requires { typename E::expression_tag; };
+
+// Expressions with at least one array leaf, only these can be evaluated
+template<typename E>
+concept SizedExpression = Expression<E> && E::sized;
+
+template<typename T>
+struct isDynamicArray : std::false_type {};
+
+template<typename T, typename A>
+struct isDynamicArray<DynamicArray<T, A>> : std::bool_constant<std::is_arithmetic_v<T>> {};
+
+template<typename T>
+concept ArrayOperand = Expression<T> || isDynamicArray<T>::value;
+
+template<typename T>
+concept Operand = ArrayOperand<T> || std::is_arithmetic_v<T>;
+
+template<typename T, typename A>
+ArrayExpr<T> asExpr(const DynamicArray<T, A>& da) noexcept {
+    return ArrayExpr<T>(da.data(), da.size());
+}
+
+template<Expression E>
+const E& asExpr(const E& e) noexcept {
+    return e;
+}
+
+template<typename T>
+requires std::is_arithmetic_v<T>
+ScalarExpr<T> asExpr(const T val) noexcept {
+    return ScalarExpr<T>(val);
+}
+
+inline constexpr size_t unsizedExpr = static_cast<size_t>(-1);
+
+template<typename E>
+size_t exprSize(const E& e) noexcept {
+    if constexpr (SizedExpression<E>) {
+        return e.size();
+    } else {
+        return unsizedExpr;
+    }
+}
+
+// Common size of the sized operands, scalars match any size
+template<typename E, typename... Es>
+requires (sizeof...(Es) > 0)
+size_t exprSize(const E& e, const Es&... es) {
+    size_t lhs = exprSize(e);
+    size_t rhs = exprSize(es...);
+    if (lhs != unsizedExpr && rhs != unsizedExpr && lhs != rhs) {
+        throw std::invalid_argument("expression operands differ in size");
+    }
+
+    return lhs != unsizedExpr ? lhs : rhs;
+}
+
+template<typename Op, typename E>
+class UnaryExpr
+{
+public:
+    using expression_tag = void;
+    using value_type     = std::invoke_result_t<Op, typename E::value_type>;
+
+    static constexpr bool sized = E::sized;
+
+    explicit UnaryExpr(const E& e) : _e(e), _size(exprSize(e)) {}
+
+    value_type operator[](const size_t key) const { return Op{}(_e[key]); }
+    size_t size() const noexcept { return _size; }
+
+private:
+    E _e;
+    size_t _size;
+};
+
+template<typename Op, typename L, typename R>
+class BinaryExpr
+{
+public:
+    using expression_tag = void;
+    using value_type     = std::invoke_result_t<Op, typename L::value_type, typename R::value_type>;
+
+    static constexpr bool sized = L::sized || R::sized;
+
+    BinaryExpr(const L& l, const R& r) : _l(l), _r(r), _size(exprSize(l, r)) {}
+
+    value_type operator[](const size_t key) const { return Op{}(_l[key], _r[key]); }
+    size_t size() const noexcept { return _size; }
+
+private:
+    L _l;
+    R _r;
+    size_t _size;
+};
+
+template<typename M, typename L, typename R>
+class SelectExpr
+{
+public:
+    using expression_tag = void;
+    using value_type     = std::common_type_t<typename L::value_type, typename R::value_type>;
+
+    static constexpr bool sized = M::sized || L::sized || R::sized;
+
+    SelectExpr(const M& m, const L& l, const R& r) : _m(m), _l(l), _r(r), _size(exprSize(m, l, r)) {}
+
+    value_type operator[](const size_t key) const {
+        return _m[key] ? value_type(_l[key]) : value_type(_r[key]);
+    }
+    size_t size() const noexcept { return _size; }
+
+private:
+    M _m;
+    L _l;
+    R _r;
+    size_t _size;
+};
+
+struct SqrtOp
+{
+    template<typename V> auto operator()(const V v) const { return std::sqrt(v); }
+};
+
+struct AbsOp
+{
+    template<typename V> auto operator()(const V v) const { return std::abs(v); }
+};
+
+template<typename Op, typename L, typename R>
+auto makeBinaryExpr(const L& l, const R& r) {
+    using LE = std::remove_cvref_t<decltype(asExpr(l))>;
+    using RE = std::remove_cvref_t<decltype(asExpr(r))>;
+    return BinaryExpr<Op, LE, RE>(asExpr(l), asExpr(r));
+}
+
+// Arithmetic, at least one operand is an array or an expression
+template<Operand L, Operand R>
+requires (ArrayOperand<L> || ArrayOperand<R>)
+auto operator+(const L& l, const R& r) { return makeBinaryExpr<std::plus<>>(l, r); }
+
+template<Operand L, Operand R>
+requires (ArrayOperand<L> || ArrayOperand<R>)
+auto operator-(const L& l, const R& r) { return makeBinaryExpr<std::minus<>>(l, r); }
+
+template<Operand L, Operand R>
+requires (ArrayOperand<L> || ArrayOperand<R>)
+auto operator*(const L& l, const R& r) { return makeBinaryExpr<std::multiplies<>>(l, r); }
+
+template<Operand L, Operand R>
+requires (ArrayOperand<L> || ArrayOperand<R>)
+auto operator/(const L& l, const R& r) { return makeBinaryExpr<std::divides<>>(l, r); }
+
+template<ArrayOperand E>
+auto operator-(const E& e) {
+    using EE = std::remove_cvref_t<decltype(asExpr(e))>;
+    return UnaryExpr<std::negate<>, EE>(asExpr(e));
+}
+
+template<ArrayOperand E>
+auto sqrt(const E& e) {
+    using EE = std::remove_cvref_t<decltype(asExpr(e))>;
+    return UnaryExpr<SqrtOp, EE>(asExpr(e));
+}
+
+template<ArrayOperand E>
+auto abs(const E& e) {
+    using EE = std::remove_cvref_t<decltype(asExpr(e))>;
+    return UnaryExpr<AbsOp, EE>(asExpr(e));
+}
+
+// Comparisons yield bool masks, excluded for two plain DynamicArrays
+template<typename L, typename R>
+concept MaskOperands = Operand<L> && Operand<R> &&
+                       (Expression<L> || Expression<R> ||
+                        (ArrayOperand<L> != ArrayOperand<R>));
+
+template<typename L, typename R> requires MaskOperands<L, R>
+auto operator<(const L& l, const R& r) { return makeBinaryExpr<std::less<>>(l, r); }
+
+template<typename L, typename R> requires MaskOperands<L, R>
+auto operator<=(const L& l, const R& r) { return makeBinaryExpr<std::less_equal<>>(l, r); }
+
+template<typename L, typename R> requires MaskOperands<L, R>
+auto operator>(const L& l, const R& r) { return makeBinaryExpr<std::greater<>>(l, r); }
+
+template<typename L, typename R> requires MaskOperands<L, R>
+auto operator>=(const L& l, const R& r) { return makeBinaryExpr<std::greater_equal<>>(l, r); }
+
+template<typename L, typename R> requires MaskOperands<L, R>
+auto operator==(const L& l, const R& r) { return makeBinaryExpr<std::equal_to<>>(l, r); }
+
+template<typename L, typename R> requires MaskOperands<L, R>
+auto operator!=(const L& l, const R& r) { return makeBinaryExpr<std::not_equal_to<>>(l, r); }
+
+// Element-wise mask ? l : r
+template<ArrayOperand M, Operand L, Operand R>
+auto select(const M& m, const L& l, const R& r) {
+    using ME = std::remove_cvref_t<decltype(asExpr(m))>;
+    using LE = std::remove_cvref_t<decltype(asExpr(l))>;
+    using RE = std::remove_cvref_t<decltype(asExpr(r))>;
+    return SelectExpr<ME, LE, RE>(asExpr(m), asExpr(l), asExpr(r));
+}
+
+// Evaluates e into dst in one pass. dst is resized only when its size
+// differs, so it may also be one of the operands.
+template<typename T, typename A, SizedExpression E>
+void evaluateInto(DynamicArray<T, A>& dst, const E& e) {
+    const size_t n = e.size();
+    if (dst.size() != n) {
+        dst.resize(n);
+    }
+
+    T* p = dst.data();
+    for (size_t i = 0; i < n; ++i) {
+        p[i] = static_cast<T>(e[i]);
+    }
+}
+
+template<SizedExpression E>
+DynamicArray<typename E::value_type> evaluate(const E& e) {
+    DynamicArray<typename E::value_type> da;
+    evaluateInto(da, e);
+
+    return da;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "FlatSet.hpp"
+
+// Sorted map with keys and values in separate DynamicArrays, so lookups
+// only touch the densely packed keys.
+// insert and erase shift both tails, prefer insert_range for bulk loads.
+
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap
+{
+public:
+    using key_type     = Key;
+    using mapped_type  = Value;
+    using size_type    = size_t;
+    using key_array    = DynamicArray<Key>;
+    using mapped_array = DynamicArray<Value>;
+
+    // Constructors
+    FlatMap() = default;
+    FlatMap(const std::initializer_list<std::pair<Key, Value>>& l);
+    FlatMap(adopt_sorted_t, key_array&& keys, mapped_array&& values);
+
+    // Lookup, find returns nullptr for a missing key
+    mapped_type* find(const key_type& key);
+    const mapped_type* find(const key_type& key) const;
+    bool contains(const key_type& key) const { return find(key) != nullptr; }
+    size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+    size_type lower_bound(const key_type& key) const;
+    mapped_type& at(const key_type& key);
+    const mapped_type& at(const key_type& key) const;
+    mapped_type& operator[](const key_type& key);
+
+    // Modifiers
+    bool insert(const key_type& key, const mapped_type& val);
+    template<typename InputIt> void insert_range(InputIt first, InputIt last);
+    size_type erase(const key_type& key);
+    void reserve(const size_type size);
+    void clear() noexcept;
+
+    // Info
+    inline size_type size() const { return _keys.size(); }
+    inline bool empty() const { return _keys.empty(); }
+    const key_array& keys() const noexcept { return _keys; }
+    const mapped_array& values() const noexcept { return _values; }
+
+private:
+    void mergeBatch(key_array& batchKeys, mapped_array& batchValues);
+
+    key_array _keys;
+    mapped_array _values;
+    Compare _comp;
+};
+
+template<typename Key, typename Value, typename Compare>
+FlatMap<Key, Value, Compare>::FlatMap(const std::initializer_list<std::pair<Key, Value>>& l) {
+    insert_range(l.begin(), l.end());
+}
+
+template<typename Key, typename Value, typename Compare>
+FlatMap<Key, Value, Compare>::FlatMap(adopt_sorted_t, key_array&& keys, mapped_array&& values) {
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("keys and values differ in size");
+    }
+
+    _keys = std::move(keys);
+    _values = std::move(values);
+}
+
+template<typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::mapped_type*
+FlatMap<Key, Value, Compare>::find(const key_type& key) {
+    size_type pos = lower_bound(key);
+    if (pos == size() || _comp(key, _keys[pos])) {
+        return nullptr;
+    }
+
+    return _values.data() + pos;
+}
+
+template<typename Key, typename Value, typename Compare>
+const typename FlatMap<Key, Value, Compare>::mapped_type*
+FlatMap<Key, Value, Compare>::find(const key_type& key) const {
+    size_type pos = lower_bound(key);
+    if (pos == size() || _comp(key, _keys[pos])) {
+        return nullptr;
+    }
+
+    return _values.data() + pos;
+}
+
+template<typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::size_type
+FlatMap<Key, Value, Compare>::lower_bound(const key_type& key) const {
+    return branchlessLowerBound(_keys.data(), _keys.size(), key, _comp);
+}
+
+template<typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::mapped_type&
+FlatMap<Key, Value, Compare>::at(const key_type& key) {
+    mapped_type* val = find(key);
+    if (val == nullptr) {
+        throw std::out_of_range("key not found");
+    }
+
+    return *val;
+}
+
+template<typename Key, typename Value, typename Compare>
+const typename FlatMap<Key, Value, Compare>::mapped_type&
+FlatMap<Key, Value, Compare>::at(const key_type& key) const {
+    const mapped_type* val = find(key);
+    if (val == nullptr) {
+        throw std::out_of_range("key not found");
+    }
+
+    return *val;
+}
+
+template<typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::mapped_type&
+FlatMap<Key, Value, Compare>::operator[](const key_type& key) {
+    size_type pos = lower_bound(key);
+    if (pos == size() || _comp(key, _keys[pos])) {
+        _keys.insert(_keys.cbegin() + static_cast<int64_t>(pos), key);
+        try {
+            _values.insert(_values.cbegin() + static_cast<int64_t>(pos), mapped_type());
+        } catch (...) {
+            _keys.erase(_keys.cbegin() + static_cast<int64_t>(pos));
+
+            throw;
+        }
+    }
+
+    return _values[pos];
+}
+
+template<typename Key, typename Value, typename Compare>
+bool FlatMap<Key, Value, Compare>::insert(const key_type& key, const mapped_type& val) {
+    size_type pos = lower_bound(key);
+    if (pos != size() && !_comp(key, _keys[pos])) {
+        return false;
+    }
+
+    _keys.insert(_keys.cbegin() + static_cast<int64_t>(pos), key);
+    try {
+        _values.insert(_values.cbegin() + static_cast<int64_t>(pos), val);
+    } catch (...) {
+        _keys.erase(_keys.cbegin() + static_cast<int64_t>(pos));
+
+        throw;
+    }
+
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename InputIt>
+void FlatMap<Key, Value, Compare>::insert_range(InputIt first, InputIt last) {
+    key_array batchKeys;
+    mapped_array batchValues;
+    if constexpr (requires { last - first; }) {
+        batchKeys.reserve(static_cast<size_type>(last - first));
+        batchValues.reserve(static_cast<size_type>(last - first));
+    }
+
+    for (; first != last; ++first) {
+        const auto& kv = *first;
+        batchKeys.push_back(kv.first);
+        batchValues.push_back(kv.second);
+    }
+
+    mergeBatch(batchKeys, batchValues);
+}
+
+template<typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::size_type
+FlatMap<Key, Value, Compare>::erase(const key_type& key) {
+    size_type pos = lower_bound(key);
+    if (pos == size() || _comp(key, _keys[pos])) {
+        return 0;
+    }
+
+    _keys.erase(_keys.cbegin() + static_cast<int64_t>(pos));
+    _values.erase(_values.cbegin() + static_cast<int64_t>(pos));
+    return 1;
+}
+
+template<typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::reserve(const size_type size) {
+    _keys.reserve(size);
+    _values.reserve(size);
+}
+
+template<typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::clear() noexcept {
+    _keys.clear();
+    _values.clear();
+}
+
+// Sorts the batch through an index permutation and merges it with the map
+// in one pass. On equal keys the existing pair is kept, then the first one
+// of the batch.
+// All comparisons are done while planning the merge, before any element is
+// moved, and existing pairs are moved only if neither key nor value move can
+// throw, so the map is left unchanged if a copy or the comparator throws.
+template<typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::mergeBatch(key_array& batchKeys, mapped_array& batchValues) {
+    constexpr bool moveExisting = std::is_nothrow_move_constructible_v<Key> &&
+                                  std::is_nothrow_move_constructible_v<Value>;
+
+    const size_type oldSize = size();
+    const size_type n = batchKeys.size();
+    if (n == 0) {
+        return;
+    }
+
+    Key* k = _keys.data();
+    Value* v = _values.data();
+    Key* bk = batchKeys.data();
+    Value* bv = batchValues.data();
+
+    DynamicArray<size_type> order;
+    order.reserve(n);
+    for (size_type i = 0; i < n; ++i) {
+        order.push_back(i);
+    }
+    std::stable_sort(order.data(), order.data() + n,
+                     [this, bk](size_type lhs, size_type rhs) { return _comp(bk[lhs], bk[rhs]); });
+
+    // Indices below oldSize refer to the map, the rest to the batch
+    DynamicArray<size_type> plan;
+    plan.reserve(oldSize + n);
+
+    const Key* taken = nullptr;
+    size_type i = 0;
+    size_type j = 0;
+    while (i < oldSize || j < n) {
+        if (j == n || (i < oldSize && !_comp(bk[order[j]], k[i]))) {
+            taken = k + i;
+            plan.push_back(i++);
+        } else if (taken == nullptr || _comp(*taken, bk[order[j]])) {
+            taken = bk + order[j];
+            plan.push_back(oldSize + order[j++]);
+        } else {
+            ++j;
+        }
+    }
+
+    key_array mergedKeys;
+    mapped_array mergedValues;
+    mergedKeys.reserve(plan.size());
+    mergedValues.reserve(plan.size());
+
+    for (size_type p = 0; p < plan.size(); ++p) {
+        size_type from = plan[p];
+        if (from >= oldSize) {
+            mergedKeys.push_back(std::move(bk[from - oldSize]));
+            mergedValues.push_back(std::move(bv[from - oldSize]));
+        } else if constexpr (moveExisting) {
+            mergedKeys.push_back(std::move(k[from]));
+            mergedValues.push_back(std::move(v[from]));
+        } else {
+            mergedKeys.push_back(k[from]);
+            mergedValues.push_back(v[from]);
+        }
+    }
+
+    _keys = std::move(mergedKeys);
+    _values = std::move(mergedValues);
+}
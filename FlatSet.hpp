@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "DynamicArray.hpp"
+
+// Tag for constructors taking an array that is already sorted and free of
+// duplicates. The array is moved in without being copied or checked.
+struct adopt_sorted_t { explicit adopt_sorted_t() = default; };
+inline constexpr adopt_sorted_t adopt_sorted{};
+
+// Branchless lower bound over a sorted range: the loop body compiles to a
+// conditional move, so there are no mispredicted jumps during the search.
+template<typename T, typename Key, typename Compare>
+size_t branchlessLowerBound(const T* first, size_t n, const Key& key, Compare& comp) {
+    if (n == 0) {
+        return 0;
+    }
+
+    const T* base = first;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = comp(base[half], key) ? base + half : base;
+        n -= half;
+    }
+
+    return static_cast<size_t>(base - first) + static_cast<size_t>(comp(*base, key));
+}
+
+// Sorted set stored contiguously in a DynamicArray.
+// insert and erase shift the tail, prefer insert_range for bulk loads.
+
+template<typename Key, typename Compare = std::less<Key>>
+class FlatSet
+{
+public:
+    using key_type        = Key;
+    using value_type      = Key;
+    using const_reference = const Key&;
+    using size_type       = size_t;
+    using const_iterator  = Iterator<const Key>;
+    using array_type      = DynamicArray<Key>;
+
+    // Constructors
+    FlatSet() = default;
+    FlatSet(const std::initializer_list<key_type>& l);
+    FlatSet(adopt_sorted_t, array_type&& keys) noexcept : _keys(std::move(keys)) {}
+
+    // Lookup
+    const_iterator find(const key_type& key) const;
+    bool contains(const key_type& key) const { return find(key) != cend(); }
+    size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+    size_type lower_bound(const key_type& key) const;
+
+    // Modifiers
+    bool insert(const key_type& key);
+    template<typename InputIt> void insert_range(InputIt first, InputIt last);
+    size_type erase(const key_type& key);
+    void reserve(const size_type size) { _keys.reserve(size); }
+    void clear() noexcept { _keys.clear(); }
+    array_type extract() && noexcept { return std::move(_keys); }
+
+    // Info
+    inline size_type size() const { return _keys.size(); }
+    inline bool empty() const { return _keys.empty(); }
+    const array_type& keys() const noexcept { return _keys; }
+
+    // Iterators
+    const_iterator cbegin() const noexcept { return _keys.cbegin(); }
+    const_iterator cend() const noexcept { return _keys.cend(); }
+
+private:
+    void mergeBatch(array_type& batch);
+
+    array_type _keys;
+    Compare _comp;
+};
+
+template<typename Key, typename Compare>
+FlatSet<Key, Compare>::FlatSet(const std::initializer_list<key_type>& l) {
+    insert_range(l.begin(), l.end());
+}
+
+template<typename Key, typename Compare>
+typename FlatSet<Key, Compare>::const_iterator
+FlatSet<Key, Compare>::find(const key_type& key) const {
+    size_type pos = lower_bound(key);
+    if (pos == size() || _comp(key, _keys[pos])) {
+        return cend();
+    }
+
+    return _keys.data() + pos;
+}
+
+template<typename Key, typename Compare>
+typename FlatSet<Key, Compare>::size_type
+FlatSet<Key, Compare>::lower_bound(const key_type& key) const {
+    return branchlessLowerBound(_keys.data(), _keys.size(), key, _comp);
+}
+
+template<typename Key, typename Compare>
+bool FlatSet<Key, Compare>::insert(const key_type& key) {
+    size_type pos = lower_bound(key);
+    if (pos != size() && !_comp(key, _keys[pos])) {
+        return false;
+    }
+
+    _keys.insert(_keys.cbegin() + static_cast<int64_t>(pos), key);
+    return true;
+}
+
+template<typename Key, typename Compare>
+template<typename InputIt>
+void FlatSet<Key, Compare>::insert_range(InputIt first, InputIt last) {
+    array_type batch;
+    if constexpr (requires { last - first; }) {
+        batch.reserve(static_cast<size_type>(last - first));
+    }
+
+    for (; first != last; ++first) {
+        batch.push_back(*first);
+    }
+
+    mergeBatch(batch);
+}
+
+template<typename Key, typename Compare>
+typename FlatSet<Key, Compare>::size_type
+FlatSet<Key, Compare>::erase(const key_type& key) {
+    size_type pos = lower_bound(key);
+    if (pos == size() || _comp(key, _keys[pos])) {
+        return 0;
+    }
+
+    _keys.erase(_keys.cbegin() + static_cast<int64_t>(pos));
+    return 1;
+}
+
+// Sorts the batch and merges it with the keys in one pass. On equal keys
+// the existing one is kept, then the first one of the batch.
+// All comparisons are done while planning the merge, before any element is
+// moved, and existing keys are moved only if that cannot throw, so the set
+// is left unchanged if a copy or the comparator throws.
+template<typename Key, typename Compare>
+void FlatSet<Key, Compare>::mergeBatch(array_type& batch) {
+    const size_type oldSize = size();
+    const size_type n = batch.size();
+    if (n == 0) {
+        return;
+    }
+
+    Key* b = batch.data();
+    std::stable_sort(b, b + n, _comp);
+
+    // Indices below oldSize refer to the keys, the rest to the batch
+    Key* k = _keys.data();
+    DynamicArray<size_type> plan;
+    plan.reserve(oldSize + n);
+
+    const Key* taken = nullptr;
+    size_type i = 0;
+    size_type j = 0;
+    while (i < oldSize || j < n) {
+        if (j == n || (i < oldSize && !_comp(b[j], k[i]))) {
+            taken = k + i;
+            plan.push_back(i++);
+        } else if (taken == nullptr || _comp(*taken, b[j])) {
+            taken = b + j;
+            plan.push_back(oldSize + j++);
+        } else {
+            ++j;
+        }
+    }
+
+    array_type merged;
+    merged.reserve(plan.size());
+    for (size_type p = 0; p < plan.size(); ++p) {
+        if (plan[p] < oldSize) {
+            merged.push_back(std::move_if_noexcept(k[plan[p]]));
+        } else {
+            merged.push_back(std::move(b[plan[p] - oldSize]));
+        }
+    }
+
+    _keys = std::move(merged);
+}
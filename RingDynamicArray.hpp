@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+#include "Allocator.hpp"
+
+// Random access iterator over a ring buffer, wraps around the end of storage
+
+template<typename T>
+class RingIterator
+{
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = std::remove_const_t<T>;
+    using difference_type   = ptrdiff_t;
+    using pointer           = T*;
+    using reference         = T&;
+
+    RingIterator() : _p(nullptr), _capacity(0), _head(0), _index(0) {}
+    RingIterator(T* const p, const size_t capacity, const size_t head, const size_t index) :
+        _p(p), _capacity(capacity), _head(head), _index(index) {}
+    operator RingIterator<const T>() const {
+        return RingIterator<const T>(_p, _capacity, _head, _index);
+    }
+
+    RingIterator& operator++() {
+        ++_index;
+        return *this;
+    }
+
+    RingIterator& operator--() {
+        --_index;
+        return *this;
+    }
+
+    RingIterator operator++(int) {
+        RingIterator prev(*this);
+        ++_index;
+        return prev;
+    }
+
+    RingIterator operator--(int) {
+        RingIterator prev(*this);
+        --_index;
+        return prev;
+    }
+
+    RingIterator& operator+=(const difference_type d) {
+        _index = static_cast<size_t>(static_cast<difference_type>(_index) + d);
+        return *this;
+    }
+
+    RingIterator& operator-=(const difference_type d) { return *this += -d; }
+
+    RingIterator operator+(const difference_type d) const { return RingIterator(*this) += d; }
+    RingIterator operator-(const difference_type d) const { return RingIterator(*this) -= d; }
+
+    difference_type operator-(const RingIterator& it) const {
+        return static_cast<difference_type>(_index) - static_cast<difference_type>(it._index);
+    }
+
+    T& operator*() const {
+        size_t i = _head + _index;
+        return _p[i < _capacity ? i : i - _capacity];
+    }
+
+    T* operator->() const { return &**this; }
+    T& operator[](const difference_type d) const { return *(*this + d); }
+
+    bool operator==(const RingIterator& it) const { return _index == it._index; }
+    std::strong_ordering operator<=>(const RingIterator& it) const { return _index <=> it._index; }
+
+private:
+    T* _p;
+    size_t _capacity;
+    size_t _head;
+    size_t _index;
+};
+
+template<typename T>
+RingIterator<T> operator+(const ptrdiff_t d, const RingIterator<T>& it) {
+    return it + d;
+}
+
+// Growable circular buffer with O(1) amortized push and pop at both ends.
+// Storage grows by at least _deltaScale elements like DynamicArray, but
+// doubles for larger sizes to keep the amortized cost constant.
+// Elements are contiguous in at most two pieces, see spans() and linearize().
+
+template<typename T, typename Allocator = Allocator<T>>
+class RingDynamicArray
+{
+public:
+    using value_type      = T;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using difference_type = ptrdiff_t;
+    using size_type       = size_t;
+    using iterator        = RingIterator<T>;
+    using const_iterator  = RingIterator<const T>;
+    using allocator       = Allocator;
+
+    // Constructors, destructor, assignment
+    RingDynamicArray() noexcept;
+    RingDynamicArray(const RingDynamicArray& ra);
+    RingDynamicArray(RingDynamicArray&& ra) noexcept;
+    RingDynamicArray(const std::initializer_list<value_type>& l);
+    ~RingDynamicArray();
+    RingDynamicArray& operator=(const RingDynamicArray& ra);
+    RingDynamicArray& operator=(RingDynamicArray&& ra) noexcept;
+
+    // Modifiers
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+    void push_front(const value_type& val) { emplace_front(val); }
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+    template<typename... Args> void emplace_back(Args&&... args);
+    template<typename... Args> void emplace_front(Args&&... args);
+    void pop_back() noexcept;
+    void pop_front() noexcept;
+    void reserve(const size_type size);
+    void clear() noexcept;
+    pointer linearize();
+
+    // Element access
+    reference front() noexcept { return _p[_head]; }
+    reference back() noexcept { return _p[physical(_size - 1)]; }
+    reference operator[](const size_type key) noexcept { return _p[physical(key)]; }
+    const_reference operator[](const size_type key) const noexcept { return _p[physical(key)]; }
+    reference at(const size_type key);
+    const_reference at(const size_type key) const;
+
+    // Contents in order as the piece from head to the end of storage and
+    // the wrapped piece at its start, the second one may be empty
+    std::pair<std::span<T>, std::span<T>> spans() noexcept;
+    std::pair<std::span<const T>, std::span<const T>> spans() const noexcept;
+
+    // Info
+    inline size_type size() const { return _size; }
+    inline size_type capacity() const { return _capacity; }
+    inline bool empty() const { return _size == 0; }
+    inline bool contiguous() const { return _head + _size <= _capacity; }
+
+    // Iterators
+    iterator begin() noexcept { return iterator(_p, _capacity, _head, 0); }
+    iterator end() noexcept { return iterator(_p, _capacity, _head, _size); }
+    const_iterator cbegin() const noexcept { return const_iterator(_p, _capacity, _head, 0); }
+    const_iterator cend() const noexcept { return const_iterator(_p, _capacity, _head, _size); }
+
+    // Non-member functions
+    template<typename S, typename A>
+    friend void swap(RingDynamicArray<S, A>& lhs, RingDynamicArray<S, A>& rhs) noexcept;
+
+private:
+    size_type physical(const size_type key) const noexcept {
+        size_type i = _head + key;
+        return i < _capacity ? i : i - _capacity;
+    }
+
+    void reallocate(const size_type capacity);
+    template<typename... Args> void growAndEmplace(const size_type key, Args&&... args);
+
+    static constexpr size_type _deltaScale = 10;
+    pointer _p;
+    size_type _head;
+    size_type _size;
+    size_type _capacity;
+    allocator alloc;
+};
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>::RingDynamicArray() noexcept :
+    _p(nullptr), _head(0), _size(0), _capacity(0) {}
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>::RingDynamicArray(const RingDynamicArray& ra) :
+    RingDynamicArray() {
+    reserve(ra._size);
+
+    for (size_type i = 0; i < ra._size; ++i) {
+        emplace_back(ra[i]);
+    }
+}
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>::RingDynamicArray(RingDynamicArray&& ra) noexcept :
+    _p(ra._p), _head(ra._head), _size(ra._size), _capacity(ra._capacity) {
+    ra._p = nullptr;
+    ra._head = 0;
+    ra._size = 0;
+    ra._capacity = 0;
+}
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>::RingDynamicArray(const std::initializer_list<T>& l) :
+    RingDynamicArray() {
+    reserve(l.size());
+
+    for (const value_type& val : l) {
+        emplace_back(val);
+    }
+}
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>::~RingDynamicArray() {
+    clear();
+    alloc.deallocate(_p, _capacity);
+}
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>&
+RingDynamicArray<T, Allocator>::operator=(const RingDynamicArray& ra) {
+    if (this == &ra) {
+        return *this;
+    }
+
+    RingDynamicArray copy(ra);
+    swap(*this, copy);
+
+    return *this;
+}
+
+template<typename T, typename Allocator>
+RingDynamicArray<T, Allocator>&
+RingDynamicArray<T, Allocator>::operator=(RingDynamicArray&& ra) noexcept {
+    if (this == &ra) {
+        return *this;
+    }
+
+    RingDynamicArray moved(std::move(ra));
+    swap(*this, moved);
+
+    return *this;
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+void RingDynamicArray<T, Allocator>::emplace_back(Args&&... args) {
+    if (_size == _capacity) {
+        growAndEmplace(_size, std::forward<Args>(args)...);
+        return;
+    }
+
+    std::construct_at(_p + physical(_size), std::forward<Args>(args)...);
+    ++_size;
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+void RingDynamicArray<T, Allocator>::emplace_front(Args&&... args) {
+    if (_size == _capacity) {
+        growAndEmplace(0, std::forward<Args>(args)...);
+        return;
+    }
+
+    size_type head = _head == 0 ? _capacity - 1 : _head - 1;
+    std::construct_at(_p + head, std::forward<Args>(args)...);
+    _head = head;
+    ++_size;
+}
+
+template<typename T, typename Allocator>
+void RingDynamicArray<T, Allocator>::pop_back() noexcept {
+    std::destroy_at(_p + physical(--_size));
+}
+
+template<typename T, typename Allocator>
+void RingDynamicArray<T, Allocator>::pop_front() noexcept {
+    std::destroy_at(_p + _head);
+    _head = physical(1);
+    --_size;
+}
+
+template<typename T, typename Allocator>
+void RingDynamicArray<T, Allocator>::reserve(const size_type size) {
+    if (_capacity >= size) {
+        return;
+    }
+
+    reallocate(size);
+}
+
+template<typename T, typename Allocator>
+void RingDynamicArray<T, Allocator>::clear() noexcept {
+    for (size_type i = 0; i < _size; ++i) {
+        std::destroy_at(_p + physical(i));
+    }
+
+    _head = 0;
+    _size = 0;
+}
+
+template<typename T, typename Allocator>
+typename RingDynamicArray<T, Allocator>::pointer
+RingDynamicArray<T, Allocator>::linearize() {
+    if (!contiguous()) {
+        reallocate(_capacity);
+    }
+
+    return _p + _head;
+}
+
+template<typename T, typename Allocator>
+typename RingDynamicArray<T, Allocator>::reference
+RingDynamicArray<T, Allocator>::at(const size_type key) {
+    if (key >= _size) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return _p[physical(key)];
+}
+
+template<typename T, typename Allocator>
+typename RingDynamicArray<T, Allocator>::const_reference
+RingDynamicArray<T, Allocator>::at(const size_type key) const {
+    if (key >= _size) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return _p[physical(key)];
+}
+
+template<typename T, typename Allocator>
+std::pair<std::span<T>, std::span<T>> RingDynamicArray<T, Allocator>::spans() noexcept {
+    if (contiguous()) {
+        return {std::span<T>(_p + _head, _size), std::span<T>()};
+    }
+
+    size_type first = _capacity - _head;
+    return {std::span<T>(_p + _head, first), std::span<T>(_p, _size - first)};
+}
+
+template<typename T, typename Allocator>
+std::pair<std::span<const T>, std::span<const T>> RingDynamicArray<T, Allocator>::spans() const noexcept {
+    if (contiguous()) {
+        return {std::span<const T>(_p + _head, _size), std::span<const T>()};
+    }
+
+    size_type first = _capacity - _head;
+    return {std::span<const T>(_p + _head, first), std::span<const T>(_p, _size - first)};
+}
+
+template<typename S, typename A>
+bool operator==(const RingDynamicArray<S, A>& lhs,
+                const RingDynamicArray<S, A>& rhs) noexcept {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    using size_type = typename RingDynamicArray<S, A>::size_type;
+    for (size_type i = 0; i < lhs.size(); ++i) {
+        if (lhs[i] != rhs[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename S, typename A>
+void swap(RingDynamicArray<S, A>& lhs,
+          RingDynamicArray<S, A>& rhs) noexcept {
+    std::swap(lhs._p, rhs._p);
+    std::swap(lhs._head, rhs._head);
+    std::swap(lhs._size, rhs._size);
+    std::swap(lhs._capacity, rhs._capacity);
+}
+
+// Moves the elements in order to the start of a new storage
+template<typename T, typename Allocator>
+void RingDynamicArray<T, Allocator>::reallocate(const size_type capacity) {
+    pointer p = alloc.allocate(capacity);
+
+    for (size_type i = 0; i < _size; ++i) {
+        pointer old = _p + physical(i);
+        std::construct_at(p + i, std::move(*old));
+        std::destroy_at(old);
+    }
+
+    alloc.deallocate(_p, _capacity);
+    _p = p;
+    _head = 0;
+    _capacity = capacity;
+}
+
+// Grows the storage with a new element at index key, which is either 0 or
+// _size. The element is constructed before the old ones are moved, since
+// args may refer to one of them.
+template<typename T, typename Allocator>
+template<typename... Args>
+void RingDynamicArray<T, Allocator>::growAndEmplace(const size_type key, Args&&... args) {
+    const size_type capacity = _capacity + std::max(_capacity, _deltaScale);
+    pointer p = alloc.allocate(capacity);
+
+    try {
+        std::construct_at(p + key, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc.deallocate(p, capacity);
+
+        throw;
+    }
+
+    const size_type shift = key == 0 ? 1 : 0;
+    for (size_type i = 0; i < _size; ++i) {
+        pointer old = _p + physical(i);
+        std::construct_at(p + i + shift, std::move(*old));
+        std::destroy_at(old);
+    }
+
+    alloc.deallocate(_p, _capacity);
+    _p = p;
+    _head = 0;
+    _capacity = capacity;
+    ++_size;
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <atomic>
+#include <stdexcept>
+
+#include "DynamicArray.hpp"
+
+// Copy-on-write sibling of DynamicArray. Copies share one immutable buffer
+// with an atomic reference count, the first mutation through a shared
+// handle makes a private copy. freeze() yields a read-only snapshot in O(1).
+//
+// Distinct handles may be used from different threads. Once non-const
+// access has handed out a reference, pointer or iterator, the handle is
+// unsharable: copies and snapshots of it get a deep copy, so writes through
+// that reference never show up in them.
+
+template<typename T, typename Allocator>
+class FrozenDynamicArray;
+
+template<typename T, typename Allocator = Allocator<T>>
+class SharedDynamicArray
+{
+public:
+    using array_type      = DynamicArray<T, Allocator>;
+    using value_type      = T;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using difference_type = ptrdiff_t;
+    using size_type       = size_t;
+    using iterator        = Iterator<T>;
+    using const_iterator  = Iterator<const T>;
+    using allocator       = Allocator;
+
+    // Constructors, destructor, assignment
+    SharedDynamicArray() noexcept : _buf(nullptr), _unsharable(false) {}
+    explicit SharedDynamicArray(const size_type size);
+    SharedDynamicArray(const std::initializer_list<value_type>& l);
+    explicit SharedDynamicArray(const array_type& da);
+    explicit SharedDynamicArray(array_type&& da);
+    SharedDynamicArray(const SharedDynamicArray& sda);
+    SharedDynamicArray(SharedDynamicArray&& sda) noexcept;
+    ~SharedDynamicArray() { release(); }
+    SharedDynamicArray& operator=(const SharedDynamicArray& sda);
+    SharedDynamicArray& operator=(SharedDynamicArray&& sda) noexcept;
+
+    // Modifiers, detach from shared buffer first
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+    template<typename... Args> void emplace_back(Args&&... args);
+    void pop_back() { mutableArray().pop_back(); }
+    iterator insert(const_iterator it, const value_type& val);
+    iterator erase(const_iterator it);
+    void resize(const size_type newSize) { mutableArray().resize(newSize); }
+    void reserve(const size_type size) { mutableArray().reserve(size); }
+    void clear() noexcept { release(); }
+
+    // Element access, non-const access makes the handle unsharable
+    reference front() { return leak().front(); }
+    reference back() { return leak().back(); }
+    reference operator[](const size_type key) { return leak()[key]; }
+    const_reference operator[](const size_type key) const noexcept { return _buf->array[key]; }
+    reference at(const size_type key);
+    const_reference at(const size_type key) const;
+    pointer data() { return leak().data(); }
+    const_pointer data() const noexcept { return _buf ? _buf->array.data() : nullptr; }
+
+    // Info
+    inline size_type size() const { return _buf ? _buf->array.size() : 0; }
+    inline size_type capacity() const { return _buf ? _buf->array.capacity() : 0; }
+    inline bool empty() const { return size() == 0; }
+    size_type use_count() const noexcept;
+    bool unique() const noexcept { return use_count() <= 1; }
+    bool sharable() const noexcept { return !_unsharable; }
+
+    // Iterators
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+    const_iterator cbegin() const noexcept { return data(); }
+    const_iterator cend() const noexcept { return data() + size(); }
+
+    // Snapshots
+    FrozenDynamicArray<T, Allocator> freeze() const;
+
+    // Non-member functions
+    template<typename S, typename A>
+    friend void swap(SharedDynamicArray<S, A>& lhs, SharedDynamicArray<S, A>& rhs) noexcept;
+
+private:
+    struct Buffer
+    {
+        explicit Buffer(const array_type& da) : refs(1), array(da) {}
+        explicit Buffer(array_type&& da) noexcept : refs(1), array(std::move(da)) {}
+
+        std::atomic<size_type> refs;
+        array_type array;
+    };
+
+    array_type& mutableArray();
+    array_type& leak();
+    Buffer* share() const;
+    void release() noexcept;
+
+    Buffer* _buf;
+    bool _unsharable;
+};
+
+// Read-only view of a SharedDynamicArray buffer. Copying is O(1), writers
+// detach before mutating and a snapshot of an unsharable handle is a deep
+// copy, so no handle can change the contents and snapshots can be handed to
+// reader threads.
+template<typename T, typename Allocator = Allocator<T>>
+class FrozenDynamicArray
+{
+public:
+    using value_type      = T;
+    using const_reference = const T&;
+    using const_pointer   = const T*;
+    using size_type       = size_t;
+    using const_iterator  = Iterator<const T>;
+
+    FrozenDynamicArray() noexcept = default;
+
+    const_reference operator[](const size_type key) const noexcept { return _array[key]; }
+    const_reference at(const size_type key) const { return _array.at(key); }
+    const_pointer data() const noexcept { return _array.data(); }
+
+    inline size_type size() const { return _array.size(); }
+    inline bool empty() const { return _array.empty(); }
+    size_type use_count() const noexcept { return _array.use_count(); }
+
+    const_iterator cbegin() const noexcept { return _array.cbegin(); }
+    const_iterator cend() const noexcept { return _array.cend(); }
+
+    // Writable handle sharing the snapshot buffer until its first mutation
+    SharedDynamicArray<T, Allocator> thaw() const noexcept { return _array; }
+
+private:
+    friend class SharedDynamicArray<T, Allocator>;
+
+    explicit FrozenDynamicArray(const SharedDynamicArray<T, Allocator>& sda) :
+        _array(sda) {}
+
+    SharedDynamicArray<T, Allocator> _array;
+};
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>::SharedDynamicArray(const size_type size) :
+    _buf(new Buffer(array_type(size))), _unsharable(false) {}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>::SharedDynamicArray(const std::initializer_list<T>& l) :
+    _buf(new Buffer(array_type(l))), _unsharable(false) {}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>::SharedDynamicArray(const array_type& da) :
+    _buf(new Buffer(da)), _unsharable(false) {}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>::SharedDynamicArray(array_type&& da) :
+    _buf(new Buffer(std::move(da))), _unsharable(false) {}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>::SharedDynamicArray(const SharedDynamicArray& sda) :
+    _buf(sda.share()), _unsharable(false) {}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>::SharedDynamicArray(SharedDynamicArray&& sda) noexcept :
+    _buf(sda._buf), _unsharable(sda._unsharable) {
+    sda._buf = nullptr;
+    sda._unsharable = false;
+}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>&
+SharedDynamicArray<T, Allocator>::operator=(const SharedDynamicArray& sda) {
+    if (_buf == sda._buf) {
+        return *this;
+    }
+
+    Buffer* buf = sda.share();
+    release();
+    _buf = buf;
+
+    return *this;
+}
+
+template<typename T, typename Allocator>
+SharedDynamicArray<T, Allocator>&
+SharedDynamicArray<T, Allocator>::operator=(SharedDynamicArray&& sda) noexcept {
+    if (this == &sda) {
+        return *this;
+    }
+
+    release();
+    _buf = sda._buf;
+    _unsharable = sda._unsharable;
+    sda._buf = nullptr;
+    sda._unsharable = false;
+
+    return *this;
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+void SharedDynamicArray<T, Allocator>::emplace_back(Args&&... args) {
+    mutableArray().emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::iterator
+SharedDynamicArray<T, Allocator>::insert(const_iterator it, const value_type& val) {
+    // it may point into the shared buffer, which is replaced on detach
+    int64_t shift = it - cbegin();
+    array_type& array = leak();
+
+    return array.insert(array.cbegin() + shift, val);
+}
+
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::iterator
+SharedDynamicArray<T, Allocator>::erase(const_iterator it) {
+    int64_t shift = it - cbegin();
+    array_type& array = leak();
+
+    return array.erase(array.cbegin() + shift);
+}
+
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::reference
+SharedDynamicArray<T, Allocator>::at(const size_type key) {
+    if (key >= size()) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return leak()[key];
+}
+
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::const_reference
+SharedDynamicArray<T, Allocator>::at(const size_type key) const {
+    if (key >= size()) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return _buf->array[key];
+}
+
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::size_type
+SharedDynamicArray<T, Allocator>::use_count() const noexcept {
+    return _buf ? _buf->refs.load(std::memory_order_relaxed) : 0;
+}
+
+template<typename T, typename Allocator>
+FrozenDynamicArray<T, Allocator> SharedDynamicArray<T, Allocator>::freeze() const {
+    return FrozenDynamicArray<T, Allocator>(*this);
+}
+
+template<typename S, typename A>
+void swap(SharedDynamicArray<S, A>& lhs,
+          SharedDynamicArray<S, A>& rhs) noexcept {
+    std::swap(lhs._buf, rhs._buf);
+    std::swap(lhs._unsharable, rhs._unsharable);
+}
+
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::array_type&
+SharedDynamicArray<T, Allocator>::mutableArray() {
+    if (_buf == nullptr) {
+        _buf = new Buffer(array_type());
+    } else if (_buf->refs.load(std::memory_order_acquire) != 1) {
+        // On throw *this still owns its share of the old buffer
+        Buffer* buf = new Buffer(_buf->array);
+        release();
+        _buf = buf;
+    }
+
+    return _buf->array;
+}
+
+// Detaches like mutableArray() and marks the handle unsharable, since the
+// caller may keep a reference into the buffer
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::array_type&
+SharedDynamicArray<T, Allocator>::leak() {
+    array_type& array = mutableArray();
+    _unsharable = true;
+
+    return array;
+}
+
+// Buffer for a new handle: the shared one, or a private copy if references
+// into this handle's buffer may be held
+template<typename T, typename Allocator>
+typename SharedDynamicArray<T, Allocator>::Buffer*
+SharedDynamicArray<T, Allocator>::share() const {
+    if (_buf == nullptr) {
+        return nullptr;
+    }
+
+    if (_unsharable) {
+        return new Buffer(_buf->array);
+    }
+
+    _buf->refs.fetch_add(1, std::memory_order_relaxed);
+    return _buf;
+}
+
+template<typename T, typename Allocator>
+void SharedDynamicArray<T, Allocator>::release() noexcept {
+    if (_buf && _buf->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete _buf;
+    }
+    _buf = nullptr;
+    _unsharable = false;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "DynamicArray.hpp"
+
+// Maps an integral key to an unsigned one with the same ordering
+template<std::integral K>
+std::make_unsigned_t<K> radixKey(const K key) noexcept {
+    using U = std::make_unsigned_t<K>;
+    U u = static_cast<U>(key);
+    if constexpr (std::is_signed_v<K>) {
+        u ^= U(1) << (sizeof(U) * 8 - 1);
+    }
+
+    return u;
+}
+
+// std::invoke for member pointers, a plain call otherwise. Going through
+// std::invoke for every callable trips -Wnoexcept on lambdas that are not
+// declared noexcept.
+template<typename KeyFn, typename T>
+decltype(auto) invokeKey(KeyFn& key, const T& val) {
+    if constexpr (std::is_member_pointer_v<KeyFn>) {
+        return std::invoke(key, val);
+    } else {
+        return key(val);
+    }
+}
+
+// Stable LSD radix sort over 8-bit digits. The key extractor is called with
+// std::invoke, so a pointer to member works, and must return an integral
+// value. The scratch buffer is kept between calls, so reuse one sorter for
+// repeated sorts of similar sizes. T must be default constructible and move
+// assignable, the scratch buffer is filled with default values on growth.
+// Passes whose digit is the same for every element are skipped.
+
+template<typename T, typename Allocator = Allocator<T>>
+class RadixSorter
+{
+public:
+    using array_type = DynamicArray<T, Allocator>;
+    using size_type  = size_t;
+
+    template<typename KeyFn = std::identity>
+    void sort(array_type& da, KeyFn key = {});
+
+    void releaseScratch() noexcept { _scratch.clear(); }
+    size_type scratchSize() const { return _scratch.size(); }
+
+private:
+    static constexpr size_type _radix = 256;
+
+    template<typename U>
+    static size_type digit(const U u, const size_type d) noexcept {
+        return static_cast<size_type>((u >> (d * 8)) & 0xff);
+    }
+
+    array_type _scratch;
+};
+
+template<typename T, typename Allocator>
+template<typename KeyFn>
+void RadixSorter<T, Allocator>::sort(array_type& da, KeyFn key) {
+    using K = std::remove_cvref_t<std::invoke_result_t<KeyFn&, const T&>>;
+    static_assert(std::is_integral_v<K>, "radix sort key must be integral");
+    constexpr size_type digits = sizeof(K);
+
+    const size_type n = da.size();
+    if (n < 2) {
+        return;
+    }
+
+    size_type counts[digits][_radix] = {};
+    for (size_type i = 0; i < n; ++i) {
+        auto u = radixKey(invokeKey(key, std::as_const(da)[i]));
+        for (size_type d = 0; d < digits; ++d) {
+            ++counts[d][digit(u, d)];
+        }
+    }
+
+    if (_scratch.size() < n) {
+        _scratch.resize(n);
+    }
+
+    T* src = da.data();
+    T* dst = _scratch.data();
+    for (size_type d = 0; d < digits; ++d) {
+        size_type* count = counts[d];
+        if (count[digit(radixKey(invokeKey(key, std::as_const(*src))), d)] == n) {
+            continue;
+        }
+
+        size_type offset = 0;
+        for (size_type b = 0; b < _radix; ++b) {
+            size_type c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        for (size_type i = 0; i < n; ++i) {
+            size_type b = digit(radixKey(invokeKey(key, std::as_const(src[i]))), d);
+            dst[count[b]++] = std::move(src[i]);
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != da.data()) {
+        std::move(src, src + n, da.data());
+    }
+}
+
+// Sorts with a temporary scratch buffer
+template<typename T, typename A, typename KeyFn = std::identity>
+void radixSort(DynamicArray<T, A>& da, KeyFn key = {}) {
+    RadixSorter<T, A> sorter;
+    sorter.sort(da, key);
+}
+
+// Reorders da so elements satisfying pred come first, returns their count.
+// Not stable.
+template<typename T, typename A, typename Pred>
+size_t partitionBy(DynamicArray<T, A>& da, Pred pred) {
+    T* first = da.data();
+    return static_cast<size_t>(std::partition(first, first + da.size(), pred) - first);
+}
+
+// Places the element that would be at index n after sorting there, with no
+// greater element before it and no smaller one after it.
+template<typename T, typename A, typename Compare = std::less<T>>
+void nthElement(DynamicArray<T, A>& da, const size_t n, Compare comp = {}) {
+    if (n >= da.size()) {
+        return;
+    }
+
+    T* first = da.data();
+    std::nth_element(first, first + n, first + da.size(), comp);
+}
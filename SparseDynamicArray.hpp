@@ -0,0 +1,297 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "DynamicArray.hpp"
+
+// Indexed array for mostly-default contents. Elements live in fixed-size
+// pages that are allocated on the first write into them, reads from an
+// untouched page return the shared default value.
+// Non-const operator[] and at() return a proxy that reads without allocating
+// and allocates the page on assignment. touch() gives a plain reference for
+// in-place modification and always allocates.
+
+template<typename T, size_t PageSize = 1024, typename Allocator = Allocator<T>>
+class SparseDynamicArray
+{
+public:
+    using value_type      = T;
+    using const_reference = const T&;
+    using size_type       = size_t;
+    using allocator       = Allocator;
+
+    static constexpr size_type pageSize = PageSize;
+
+    class reference
+    {
+    public:
+        reference(SparseDynamicArray* sa, const size_type key) noexcept : _sa(sa), _key(key) {}
+
+        operator const_reference() const noexcept { return _sa->get(_key); }
+        reference& operator=(const value_type& val) {
+            _sa->touch(_key) = val;
+            return *this;
+        }
+        reference& operator=(value_type&& val) {
+            _sa->touch(_key) = std::move(val);
+            return *this;
+        }
+        reference& operator=(const reference& ref) { return *this = static_cast<const_reference>(ref); }
+
+    private:
+        SparseDynamicArray* _sa;
+        size_type _key;
+    };
+
+    // Constructors, destructor, assignment
+    SparseDynamicArray() : _size(0), _default() {}
+    explicit SparseDynamicArray(const size_type size, const value_type& def = value_type());
+    SparseDynamicArray(const SparseDynamicArray& sa);
+    SparseDynamicArray(SparseDynamicArray&& sa) noexcept(std::is_nothrow_copy_constructible_v<T>);
+    ~SparseDynamicArray();
+    SparseDynamicArray& operator=(const SparseDynamicArray& sa);
+    SparseDynamicArray& operator=(SparseDynamicArray&& sa) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    // Element access
+    const_reference get(const size_type key) const noexcept;
+    const_reference operator[](const size_type key) const noexcept { return get(key); }
+    reference operator[](const size_type key) noexcept { return reference(this, key); }
+    const_reference at(const size_type key) const;
+    reference at(const size_type key);
+    T& touch(const size_type key) { return materialize(key / pageSize)[key % pageSize]; }
+    void set(const size_type key, const value_type& val) { touch(key) = val; }
+    const_reference defaultValue() const noexcept { return _default; }
+
+    // Modifiers
+    void resize(const size_type newSize);
+    void clear() noexcept;
+    void releasePage(const size_type page) noexcept;
+
+    // Copies every element into a dense array
+    DynamicArray<T> compact() const;
+
+    // Info
+    inline size_type size() const { return _size; }
+    inline bool empty() const { return _size == 0; }
+    inline size_type pages() const { return _pages.size(); }
+    size_type allocatedPages() const noexcept;
+    bool isAllocated(const size_type key) const noexcept { return _pages[key / pageSize] != nullptr; }
+
+    // Non-member functions
+    template<typename S, size_t P, typename A>
+    friend void swap(SparseDynamicArray<S, P, A>& lhs, SparseDynamicArray<S, P, A>& rhs) noexcept;
+
+private:
+    static size_type pagesFor(const size_type size) noexcept { return (size + pageSize - 1) / pageSize; }
+
+    T* materialize(const size_type page);
+    T* allocatePage(const T* src);
+    void destroyPage(T* p) noexcept;
+
+    DynamicArray<T*> _pages;
+    size_type _size;
+    value_type _default;
+    allocator alloc;
+};
+
+template<typename T, size_t PageSize, typename Allocator>
+SparseDynamicArray<T, PageSize, Allocator>::SparseDynamicArray(const size_type size, const value_type& def) :
+    _pages(pagesFor(size)), _size(size), _default(def) {}
+
+template<typename T, size_t PageSize, typename Allocator>
+SparseDynamicArray<T, PageSize, Allocator>::SparseDynamicArray(const SparseDynamicArray& sa) :
+    _pages(sa._pages.size()), _size(sa._size), _default(sa._default) {
+    try {
+        for (size_type i = 0; i < sa._pages.size(); ++i) {
+            if (sa._pages[i] != nullptr) {
+                _pages[i] = allocatePage(sa._pages[i]);
+            }
+        }
+    } catch (...) {
+        clear();
+
+        throw;
+    }
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+SparseDynamicArray<T, PageSize, Allocator>::SparseDynamicArray(SparseDynamicArray&& sa)
+    noexcept(std::is_nothrow_copy_constructible_v<T>) :
+    // The default is copied so a moved-from array still reads it
+    _pages(std::move(sa._pages)), _size(sa._size), _default(sa._default) {
+    sa._size = 0;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+SparseDynamicArray<T, PageSize, Allocator>::~SparseDynamicArray() {
+    clear();
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+SparseDynamicArray<T, PageSize, Allocator>&
+SparseDynamicArray<T, PageSize, Allocator>::operator=(const SparseDynamicArray& sa) {
+    if (this == &sa) {
+        return *this;
+    }
+
+    SparseDynamicArray copy(sa);
+    swap(*this, copy);
+
+    return *this;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+SparseDynamicArray<T, PageSize, Allocator>&
+SparseDynamicArray<T, PageSize, Allocator>::operator=(SparseDynamicArray&& sa)
+    noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    if (this == &sa) {
+        return *this;
+    }
+
+    SparseDynamicArray moved(std::move(sa));
+    swap(*this, moved);
+
+    return *this;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+typename SparseDynamicArray<T, PageSize, Allocator>::const_reference
+SparseDynamicArray<T, PageSize, Allocator>::get(const size_type key) const noexcept {
+    const T* p = _pages[key / pageSize];
+    return p != nullptr ? p[key % pageSize] : _default;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+typename SparseDynamicArray<T, PageSize, Allocator>::const_reference
+SparseDynamicArray<T, PageSize, Allocator>::at(const size_type key) const {
+    if (key >= _size) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return get(key);
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+typename SparseDynamicArray<T, PageSize, Allocator>::reference
+SparseDynamicArray<T, PageSize, Allocator>::at(const size_type key) {
+    if (key >= _size) {
+        throw std::out_of_range("index of element out of range");
+    }
+
+    return reference(this, key);
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+void SparseDynamicArray<T, PageSize, Allocator>::resize(const size_type newSize) {
+    const size_type newPages = pagesFor(newSize);
+    for (size_type i = newPages; i < _pages.size(); ++i) {
+        releasePage(i);
+    }
+
+    if (newPages != _pages.size()) {
+        _pages.resize(newPages);
+    }
+
+    // Elements past the old size in a kept page must read as default again
+    if (newSize > _size && _size % pageSize != 0 && _pages[_size / pageSize] != nullptr) {
+        T* p = _pages[_size / pageSize];
+        const size_type last = newSize / pageSize == _size / pageSize ? newSize % pageSize : pageSize;
+        for (size_type i = _size % pageSize; i < last; ++i) {
+            p[i] = _default;
+        }
+    }
+
+    _size = newSize;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+void SparseDynamicArray<T, PageSize, Allocator>::clear() noexcept {
+    for (size_type i = 0; i < _pages.size(); ++i) {
+        releasePage(i);
+    }
+    _pages.clear();
+    _size = 0;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+void SparseDynamicArray<T, PageSize, Allocator>::releasePage(const size_type page) noexcept {
+    if (_pages[page] != nullptr) {
+        destroyPage(_pages[page]);
+        _pages[page] = nullptr;
+    }
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+DynamicArray<T> SparseDynamicArray<T, PageSize, Allocator>::compact() const {
+    DynamicArray<T> da;
+    da.reserve(_size);
+
+    for (size_type i = 0; i < _size; ++i) {
+        da.push_back(get(i));
+    }
+
+    return da;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+typename SparseDynamicArray<T, PageSize, Allocator>::size_type
+SparseDynamicArray<T, PageSize, Allocator>::allocatedPages() const noexcept {
+    size_type n = 0;
+    for (size_type i = 0; i < _pages.size(); ++i) {
+        if (_pages[i] != nullptr) {
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+template<typename S, size_t P, typename A>
+void swap(SparseDynamicArray<S, P, A>& lhs,
+          SparseDynamicArray<S, P, A>& rhs) noexcept {
+    swap(lhs._pages, rhs._pages);
+    std::swap(lhs._size, rhs._size);
+    std::swap(lhs._default, rhs._default);
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+T* SparseDynamicArray<T, PageSize, Allocator>::materialize(const size_type page) {
+    if (_pages[page] == nullptr) {
+        _pages[page] = allocatePage(nullptr);
+    }
+
+    return _pages[page];
+}
+
+// Copies src into a new page, or fills it with the default if src is null
+template<typename T, size_t PageSize, typename Allocator>
+T* SparseDynamicArray<T, PageSize, Allocator>::allocatePage(const T* src) {
+    T* p = alloc.allocate(pageSize);
+
+    size_type i = 0;
+    try {
+        for (; i < pageSize; ++i) {
+            std::construct_at(p + i, src != nullptr ? src[i] : _default);
+        }
+    } catch (...) {
+        for (size_type pi = 0; pi < i; ++pi) {
+            std::destroy_at(p + pi);
+        }
+        alloc.deallocate(p, pageSize);
+
+        throw;
+    }
+
+    return p;
+}
+
+template<typename T, size_t PageSize, typename Allocator>
+void SparseDynamicArray<T, PageSize, Allocator>::destroyPage(T* p) noexcept {
+    for (size_type i = 0; i < pageSize; ++i) {
+        std::destroy_at(p + i);
+    }
+    alloc.deallocate(p, pageSize);
+}
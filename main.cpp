@@ -1,9 +1,23 @@
 #include <vector>
 #include <exception>
+#include <thread>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <deque>
 
 #include <gtest/gtest.h>
 
 #include "DynamicArray.hpp"
+#include "SharedDynamicArray.hpp"
+#include "FlatSet.hpp"
+#include "FlatMap.hpp"
+#include "BitArray.hpp"
+#include "Sorting.hpp"
+#include "RingDynamicArray.hpp"
+#include "Expression.hpp"
+#include "CompressedIntArray.hpp"
+#include "SparseDynamicArray.hpp"
 #include "utils.hpp"
 
 const size_t size = 1'000;
@@ -282,6 +296,755 @@ TEST(DynamicArrayTest, SpaceShuttleOperator) {
     ASSERT_GE(da3, da1);
 }
 
+TEST(SharedDynamicArrayTest, CopySharesBuffer) {
+    DynamicArray<int> da;
+    initializeWithRandNumbers(da, size, 0, size);
+
+    SharedDynamicArray<int> sda(da);
+    const SharedDynamicArray<int> sdaCopy(sda);
+    ASSERT_EQ(2, sda.use_count());
+    ASSERT_EQ(std::as_const(sda).data(), sdaCopy.data());
+
+    for (size_t p = 0; p < da.size(); ++p) {
+        ASSERT_EQ(da[p], sdaCopy[p]);
+    }
+}
+
+TEST(SharedDynamicArrayTest, MutationDetaches) {
+    SharedDynamicArray<int> sda{0,1,2,3,4,5,6,7,8,9};
+    SharedDynamicArray<int> sdaCopy(sda);
+
+    sdaCopy[0] = 100;
+    sdaCopy.push_back(10);
+    sdaCopy.erase(sdaCopy.cbegin() + 1);
+    sdaCopy.insert(sdaCopy.cbegin() + 1, 1);
+
+    ASSERT_EQ(1, sda.use_count());
+    ASSERT_EQ(1, sdaCopy.use_count());
+    ASSERT_EQ(10, sda.size());
+    ASSERT_EQ(11, sdaCopy.size());
+    for (size_t p = 0; p < sda.size(); ++p) {
+        ASSERT_EQ(static_cast<int>(p), std::as_const(sda)[p]);
+    }
+    ASSERT_EQ(100, std::as_const(sdaCopy)[0]);
+    for (size_t p = 1; p < sdaCopy.size(); ++p) {
+        ASSERT_EQ(static_cast<int>(p), std::as_const(sdaCopy)[p]);
+    }
+}
+
+TEST(SharedDynamicArrayTest, FreezeSnapshot) {
+    SharedDynamicArray<int> sda;
+    initializeWithRandNumbers(sda, size, 0, size);
+
+    FrozenDynamicArray<int> snapshot = sda.freeze();
+    ASSERT_EQ(std::as_const(sda).data(), snapshot.data());
+
+    DynamicArray<int> sample;
+    for (size_t p = 0; p < snapshot.size(); ++p) {
+        sample.push_back(snapshot[p]);
+    }
+
+    sda[0] += 1;
+    sda.push_back(0);
+    ASSERT_EQ(size, snapshot.size());
+    ASSERT_EQ(1, snapshot.use_count());
+
+    std::vector<std::thread> readers;
+    std::vector<int> matches(4, 0);
+    for (size_t t = 0; t < matches.size(); ++t) {
+        readers.emplace_back([&, t] {
+            FrozenDynamicArray<int> local(snapshot);
+            bool equal = true;
+            for (size_t p = 0; p < local.size(); ++p) {
+                equal = equal && local[p] == sample[p];
+            }
+            matches[t] = equal;
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    for (int match : matches) {
+        ASSERT_TRUE(match);
+    }
+    ASSERT_EQ(1, snapshot.use_count());
+}
+
+TEST(SharedDynamicArrayTest, FreezeAfterReferenceLeak) {
+    SharedDynamicArray<int> sda{0,1,2,3,4,5,6,7,8,9};
+
+    int& ref = sda[0];
+    int* raw = sda.data();
+    ASSERT_FALSE(sda.sharable());
+
+    FrozenDynamicArray<int> snapshot = sda.freeze();
+    const SharedDynamicArray<int> sdaCopy(sda);
+    ref = 99;
+    raw[1] = 98;
+
+    ASSERT_NE(std::as_const(sda).data(), snapshot.data());
+    ASSERT_EQ(1, sda.use_count());
+    ASSERT_EQ(99, std::as_const(sda)[0]);
+    ASSERT_EQ(98, std::as_const(sda)[1]);
+    for (size_t p = 0; p < snapshot.size(); ++p) {
+        ASSERT_EQ(static_cast<int>(p), snapshot[p]);
+        ASSERT_EQ(static_cast<int>(p), sdaCopy[p]);
+    }
+
+    // Copies of a snapshot share again
+    SharedDynamicArray<int> thawed = snapshot.thaw();
+    ASSERT_EQ(2, snapshot.use_count());
+    ASSERT_TRUE(thawed.sharable());
+}
+
+TEST(FlatSetTest, InsertRange) {
+    DynamicArray<int> da;
+    initializeWithRandNumbers(da, size, 0, size);
+
+    std::set<int> sample;
+    FlatSet<int> fs;
+    for (size_t p = 0; p < da.size() / 2; ++p) {
+        ASSERT_EQ(sample.insert(da[p]).second, fs.insert(da[p]));
+    }
+    for (size_t p = da.size() / 2; p < da.size(); ++p) {
+        sample.insert(da[p]);
+    }
+    fs.insert_range(da.begin() + static_cast<int64_t>(da.size() / 2), da.end());
+
+    ASSERT_EQ(sample.size(), fs.size());
+    auto it = fs.cbegin();
+    for (int key : sample) {
+        ASSERT_EQ(key, *it);
+        ++it;
+    }
+}
+
+TEST(FlatSetTest, FindErase) {
+    FlatSet<int> fs{9,3,7,1,5,3,9};
+    ASSERT_EQ(5, fs.size());
+
+    for (int key = 0; key < 10; ++key) {
+        ASSERT_EQ(key % 2 == 1, fs.contains(key));
+    }
+    ASSERT_EQ(fs.cend(), fs.find(4));
+    ASSERT_EQ(7, *fs.find(7));
+
+    ASSERT_EQ(1, fs.erase(7));
+    ASSERT_EQ(0, fs.erase(7));
+    ASSERT_FALSE(fs.contains(7));
+    ASSERT_EQ(4, fs.size());
+}
+
+TEST(FlatMapTest, InsertRangeKeepsFirst) {
+    std::vector<std::pair<int, size_t>> pairs;
+    DynamicArray<int> da;
+    initializeWithRandNumbers(da, size, 0, size);
+    for (size_t p = 0; p < da.size(); ++p) {
+        pairs.emplace_back(da[p], p);
+    }
+
+    std::map<int, size_t> sample;
+    FlatMap<int, size_t> fm;
+    for (size_t p = 0; p < pairs.size() / 2; ++p) {
+        sample.insert(pairs[p]);
+        fm.insert(pairs[p].first, pairs[p].second);
+    }
+    sample.insert(pairs.begin() + size / 2, pairs.end());
+    fm.insert_range(pairs.begin() + size / 2, pairs.end());
+
+    ASSERT_EQ(sample.size(), fm.size());
+    size_t p = 0;
+    for (const auto& kv : sample) {
+        ASSERT_EQ(kv.first, fm.keys()[p]);
+        ASSERT_EQ(kv.second, fm.values()[p]);
+        ASSERT_EQ(kv.second, fm.at(kv.first));
+        ++p;
+    }
+}
+
+TEST(FlatMapTest, InsertRangeThrowLeavesMapUnchanged) {
+    static int count = 0;
+    struct CopyConstructorThrow {
+        CopyConstructorThrow(int v) : n(v) {}
+        CopyConstructorThrow(const CopyConstructorThrow& obj) : n(obj.n) {
+            if (++count == 3) {
+                throw std::runtime_error("CopyConstructorThrows");
+            }
+        }
+        CopyConstructorThrow(CopyConstructorThrow&& obj) noexcept : n(obj.n) {}
+        int n;
+    };
+
+    FlatMap<int, CopyConstructorThrow> fm;
+    fm.insert(5, CopyConstructorThrow(50));
+
+    std::vector<std::pair<int, CopyConstructorThrow>> pairs;
+    for (int i = 1; i <= 4; ++i) {
+        pairs.emplace_back(i * 2, CopyConstructorThrow(i * 20));
+    }
+
+    count = 0;
+    ASSERT_ANY_THROW(fm.insert_range(pairs.begin(), pairs.end()));
+    ASSERT_EQ(1, fm.size());
+    ASSERT_EQ(1, fm.values().size());
+    ASSERT_TRUE(fm.contains(5));
+    ASSERT_EQ(50, fm.at(5).n);
+
+    count = -100;
+    fm.insert_range(pairs.begin(), pairs.end());
+    ASSERT_EQ(5, fm.size());
+    ASSERT_EQ(5, fm.values().size());
+    for (size_t p = 0; p < fm.size(); ++p) {
+        ASSERT_EQ(fm.keys()[p] * 10, fm.values()[p].n);
+    }
+}
+
+TEST(FlatSetTest, InsertRangeComparatorThrow) {
+    static int count = 0;
+    struct CompareThrow {
+        bool operator()(int lhs, int rhs) const {
+            if (++count == 20) {
+                throw std::runtime_error("CompareThrows");
+            }
+            return lhs < rhs;
+        }
+    };
+
+    FlatSet<int, CompareThrow> fs{1, 3, 5};
+    DynamicArray<int> batch{9, 2, 8, 4, 7, 6, 0};
+
+    count = 0;
+    ASSERT_ANY_THROW(fs.insert_range(batch.begin(), batch.end()));
+    ASSERT_EQ((DynamicArray<int>{1, 3, 5}), fs.keys());
+}
+
+TEST(FlatMapTest, AdoptSorted) {
+    DynamicArray<int> keys{1,3,5,7};
+    DynamicArray<std::string> values{"1","3","5","7"};
+    const int* keysData = keys.data();
+
+    FlatMap<int, std::string> fm(adopt_sorted, std::move(keys), std::move(values));
+    ASSERT_EQ(keysData, fm.keys().data());
+    ASSERT_EQ("5", fm.at(5));
+    ASSERT_EQ(nullptr, fm.find(4));
+    ASSERT_ANY_THROW(fm.at(4));
+
+    fm[4] = "4";
+    ASSERT_EQ(5, fm.size());
+    ASSERT_EQ("4", fm.values()[2]);
+    ASSERT_EQ(1, fm.erase(1));
+    ASSERT_EQ(3, fm.keys()[0]);
+}
+
+TEST(BitArrayTest, SetResetFlip) {
+    const size_t bits = size + 7;
+    BitArray<> ba(bits);
+    std::vector<bool> sample(bits);
+
+    ba.set(3, 700);
+    ba.reset(64, 128);
+    ba.flip(100, bits);
+    ba[5] = false;
+    ba.flip(6);
+    for (size_t p = 3; p < 700; ++p) {
+        sample[p] = true;
+    }
+    for (size_t p = 64; p < 128; ++p) {
+        sample[p] = false;
+    }
+    for (size_t p = 100; p < bits; ++p) {
+        sample[p] = !sample[p];
+    }
+    sample[5] = false;
+    sample[6] = !sample[6];
+
+    size_t ones = 0;
+    for (size_t p = 0; p < bits; ++p) {
+        ASSERT_EQ(sample[p], ba[p]);
+        ones += sample[p];
+    }
+    ASSERT_EQ(ones, ba.count());
+    ASSERT_ANY_THROW(ba.at(bits));
+
+    ba.flip();
+    ASSERT_EQ(bits - ones, ba.count());
+    ba.set();
+    ASSERT_TRUE(ba.all());
+    ba.reset();
+    ASSERT_TRUE(ba.none());
+}
+
+TEST(BitArrayTest, FindSetBits) {
+    BitArray<> ba;
+    DynamicArray<size_t> positions;
+    for (size_t p = 0; p < size; ++p) {
+        ba.push_back(p % 37 == 5 || p % 150 == 0);
+        if (ba[p]) {
+            positions.push_back(p);
+        }
+    }
+
+    size_t pos = ba.find_first();
+    for (size_t p = 0; p < positions.size(); ++p) {
+        ASSERT_EQ(positions[p], pos);
+        pos = ba.find_next(pos);
+    }
+    ASSERT_EQ(ba.size(), pos);
+
+    ba.resize(10);
+    ASSERT_EQ(2, ba.count());
+    ASSERT_EQ(0, ba.find_first());
+    ASSERT_EQ(5, ba.find_next(0));
+    ASSERT_EQ(10, ba.find_next(5));
+}
+
+TEST(BitArrayTest, BulkOperations) {
+    BitArray<> lhs(size), rhs(size);
+    for (size_t p = 0; p < size; ++p) {
+        lhs[p] = p % 2 == 0;
+        rhs[p] = p % 3 == 0;
+    }
+
+    BitArray<> andBits = lhs & rhs;
+    BitArray<> orBits = lhs | rhs;
+    BitArray<> xorBits = lhs ^ rhs;
+    for (size_t p = 0; p < size; ++p) {
+        ASSERT_EQ(p % 6 == 0, andBits[p]);
+        ASSERT_EQ(p % 2 == 0 || p % 3 == 0, orBits[p]);
+        ASSERT_EQ((p % 2 == 0) != (p % 3 == 0), xorBits[p]);
+    }
+
+    ASSERT_TRUE((xorBits ^ rhs) == lhs);
+    BitArray<> other(size + 1);
+    ASSERT_ANY_THROW(lhs &= other);
+}
+
+TEST(BitArrayTest, MoveAndGrow) {
+    BitArray<> bits;
+    bits.reserve(2 * size);
+    const uint64_t* storage = bits.data();
+    for (size_t p = 0; p < size; ++p) {
+        bits.push_back(p % 5 == 0);
+    }
+    ASSERT_EQ(storage, bits.data());
+    ASSERT_EQ(size, bits.size());
+    ASSERT_EQ((size + 4) / 5, bits.count());
+
+    BitArray<> moved(std::move(bits));
+    ASSERT_EQ(size, moved.size());
+    ASSERT_EQ(0, bits.size());
+    ASSERT_EQ(0, bits.words());
+
+    bits.push_back(true);
+    bits.set();
+    ASSERT_EQ(1, bits.size());
+    ASSERT_TRUE(bits.all());
+
+    moved = std::move(bits);
+    ASSERT_EQ(1, moved.size());
+    ASSERT_TRUE(bits.empty());
+    for (size_t p = 0; p < size; ++p) {
+        bits.push_back(p % 2 == 0);
+    }
+    ASSERT_EQ(size / 2, bits.count());
+}
+
+TEST(SortingTest, RadixSortIntegral) {
+    DynamicArray<int> da;
+    initializeWithRandNumbers(da, size, -static_cast<int>(size), size);
+    std::vector<int> sample(da.data(), da.data() + da.size());
+    std::sort(sample.begin(), sample.end());
+
+    radixSort(da);
+    ASSERT_EQ(sample.size(), da.size());
+    for (size_t p = 0; p < da.size(); ++p) {
+        ASSERT_EQ(sample[p], da[p]);
+    }
+
+    DynamicArray<uint64_t> wide{5, 1ull << 60, 0, 3, 1ull << 33, 3};
+    radixSort(wide);
+    ASSERT_EQ((DynamicArray<uint64_t>{0, 3, 3, 5, 1ull << 33, 1ull << 60}), wide);
+}
+
+TEST(SortingTest, RadixSortKeyExtractorStable) {
+    struct Tagged {
+        int16_t key;
+        size_t order;
+    };
+
+    DynamicArray<int> keys;
+    initializeWithRandNumbers(keys, size, 0, 100);
+    DynamicArray<Tagged> da;
+    for (size_t p = 0; p < keys.size(); ++p) {
+        da.push_back(Tagged{static_cast<int16_t>(keys[p]), p});
+    }
+
+    RadixSorter<Tagged> sorter;
+    sorter.sort(da, [](const Tagged& t) { return t.key; });
+    ASSERT_EQ(size, sorter.scratchSize());
+
+    for (size_t p = 1; p < da.size(); ++p) {
+        ASSERT_LE(da[p - 1].key, da[p].key);
+        if (da[p - 1].key == da[p].key) {
+            ASSERT_LT(da[p - 1].order, da[p].order);
+        }
+    }
+
+    sorter.sort(da, [](const Tagged& t) { return -t.key; });
+    for (size_t p = 1; p < da.size(); ++p) {
+        ASSERT_GE(da[p - 1].key, da[p].key);
+    }
+
+    sorter.sort(da, &Tagged::order);
+    for (size_t p = 0; p < da.size(); ++p) {
+        ASSERT_EQ(p, da[p].order);
+        ASSERT_EQ(static_cast<int16_t>(keys[p]), da[p].key);
+    }
+}
+
+TEST(SortingTest, PartitionNthElement) {
+    DynamicArray<int> da;
+    initializeWithRandNumbers(da, size, 0, size);
+    std::vector<int> sample(da.data(), da.data() + da.size());
+    std::sort(sample.begin(), sample.end());
+
+    const size_t n = size / 3;
+    nthElement(da, n);
+    ASSERT_EQ(sample[n], da[n]);
+    for (size_t p = 0; p < da.size(); ++p) {
+        ASSERT_TRUE(p < n ? da[p] <= da[n] : da[p] >= da[n]);
+    }
+
+    size_t evens = partitionBy(da, [](int v) { return v % 2 == 0; });
+    for (size_t p = 0; p < da.size(); ++p) {
+        ASSERT_EQ(p < evens, da[p] % 2 == 0);
+    }
+}
+
+TEST(RingDynamicArrayTest, PushPopBothEnds) {
+    DynamicArray<int> da;
+    initializeWithRandNumbers(da, size, 0, size);
+
+    std::deque<int> sample;
+    RingDynamicArray<int> ra;
+    for (size_t p = 0; p < da.size(); ++p) {
+        if (da[p] % 3 == 0) {
+            sample.push_front(da[p]);
+            ra.push_front(da[p]);
+        } else {
+            sample.push_back(da[p]);
+            ra.push_back(da[p]);
+        }
+
+        if (da[p] % 5 == 0) {
+            sample.pop_front();
+            ra.pop_front();
+        } else if (da[p] % 7 == 0) {
+            sample.pop_back();
+            ra.pop_back();
+        }
+    }
+
+    ASSERT_EQ(sample.size(), ra.size());
+    for (size_t p = 0; p < ra.size(); ++p) {
+        ASSERT_EQ(sample[p], ra[p]);
+    }
+    ASSERT_ANY_THROW(ra.at(ra.size()));
+
+    RingDynamicArray<int> raCopy(ra);
+    ASSERT_TRUE(raCopy == ra);
+}
+
+TEST(RingDynamicArrayTest, SelfReferencingPushOnGrowth) {
+    RingDynamicArray<std::string> ra;
+    for (size_t i = 0; i < 10; ++i) {
+        ra.push_back(std::string(32, static_cast<char>('a' + i)));
+    }
+    ASSERT_EQ(ra.size(), ra.capacity());
+
+    ra.push_back(ra.front());
+    ra.pop_front();
+    ASSERT_EQ(std::string(32, 'a'), ra.back());
+
+    while (ra.size() < ra.capacity()) {
+        ra.push_back(std::string(32, 'z'));
+    }
+    ra.push_front(ra.back());
+    ASSERT_EQ(std::string(32, 'z'), ra.front());
+    ASSERT_EQ(std::string(32, 'b'), ra[1]);
+}
+
+TEST(RingDynamicArrayTest, WrapAroundIterators) {
+    RingDynamicArray<int> ra;
+    ra.reserve(10);
+    for (int i = 0; i < 10; ++i) {
+        ra.push_back(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        ra.pop_front();
+        ra.push_back(10 + i);
+    }
+
+    ASSERT_EQ(10, ra.capacity());
+    ASSERT_FALSE(ra.contiguous());
+    ASSERT_EQ(10, ra.end() - ra.begin());
+
+    int expected = 6;
+    for (auto it = ra.cbegin(); it != ra.cend(); ++it) {
+        ASSERT_EQ(expected++, *it);
+    }
+    ASSERT_EQ(12, ra.begin()[6]);
+
+    std::sort(ra.begin(), ra.end(), std::greater<int>());
+    ASSERT_EQ(15, ra.front());
+    ASSERT_EQ(6, ra.back());
+}
+
+TEST(RingDynamicArrayTest, SpansLinearize) {
+    RingDynamicArray<int> ra;
+    for (int i = 0; i < 10; ++i) {
+        ra.push_back(i);
+    }
+    for (int i = 1; i <= 3; ++i) {
+        ra.push_front(-i);
+    }
+
+    auto [first, second] = std::as_const(ra).spans();
+    ASSERT_EQ(ra.size(), first.size() + second.size());
+    ASSERT_FALSE(second.empty());
+    int expected = -3;
+    for (int v : first) {
+        ASSERT_EQ(expected++, v);
+    }
+    for (int v : second) {
+        ASSERT_EQ(expected++, v);
+    }
+
+    const int* p = ra.linearize();
+    ASSERT_TRUE(ra.contiguous());
+    ASSERT_TRUE(ra.spans().second.empty());
+    for (size_t i = 0; i < ra.size(); ++i) {
+        ASSERT_EQ(static_cast<int>(i) - 3, p[i]);
+    }
+}
+
+TEST(ExpressionTest, FusedArithmetic) {
+    DynamicArray<int> ints;
+    initializeWithRandNumbers(ints, 2 * size, 0, size);
+
+    DynamicArray<double> a, b;
+    for (size_t p = 0; p < size; ++p) {
+        a.push_back(ints[p]);
+        b.push_back(ints[size + p] == 0 ? 1 : ints[size + p]);
+    }
+
+    DynamicArray<double> result = evaluate(sqrt(abs(a * b - 2.0)) + a / b * 0.5 - (-b));
+    ASSERT_EQ(size, result.size());
+    for (size_t p = 0; p < size; ++p) {
+        ASSERT_DOUBLE_EQ(std::sqrt(std::abs(a[p] * b[p] - 2.0)) + a[p] / b[p] * 0.5 + b[p], result[p]);
+    }
+
+    const double* data = a.data();
+    evaluateInto(a, a + b);
+    ASSERT_EQ(data, a.data());
+    for (size_t p = 0; p < size; ++p) {
+        ASSERT_DOUBLE_EQ(ints[p] + b[p], a[p]);
+    }
+
+    DynamicArray<double> shorter(size - 1);
+    ASSERT_ANY_THROW(a + shorter);
+}
+
+TEST(ExpressionTest, MasksSelect) {
+    DynamicArray<double> a{-2.0, -1.0, 0.0, 1.0, 2.0};
+    DynamicArray<double> b{ 2.0,  1.0, 0.0, 2.0, 1.0};
+
+    DynamicArray<bool> less = evaluate(asExpr(a) < b);
+    DynamicArray<bool> positive = evaluate(a > 0.0);
+    DynamicArray<bool> equal = evaluate(asExpr(a) == b);
+    ASSERT_EQ((DynamicArray<bool>{true, true, false, true, false}), less);
+    ASSERT_EQ((DynamicArray<bool>{false, false, false, true, true}), positive);
+    ASSERT_EQ((DynamicArray<bool>{false, false, true, false, false}), equal);
+
+    DynamicArray<double> clamped = evaluate(select(a < 0.0, 0.0, a));
+    ASSERT_EQ((DynamicArray<double>{0.0, 0.0, 0.0, 1.0, 2.0}), clamped);
+
+    DynamicArray<double> maxed = evaluate(select(asExpr(a) > b, a, b));
+    ASSERT_EQ((DynamicArray<double>{2.0, 1.0, 0.0, 2.0, 2.0}), maxed);
+
+    ASSERT_TRUE(a < b);
+}
+
+TEST(ExpressionTest, UnsizedRejected) {
+    DynamicArray<double> a{1.0, 4.0, 9.0};
+
+    // Expressions without an array operand have no size to evaluate to
+    static_assert(!SizedExpression<decltype(asExpr(2.0) + 1.0)>);
+    static_assert(!SizedExpression<decltype(sqrt(asExpr(3.0)))>);
+    static_assert(!SizedExpression<decltype(select(asExpr(true), 1.0, 2.0))>);
+    static_assert(SizedExpression<decltype(asExpr(2.0) + a)>);
+    static_assert(SizedExpression<decltype(select(asExpr(true), a, 2.0))>);
+
+    DynamicArray<double> shifted = evaluate(sqrt(asExpr(2.0) * 2.0) + a);
+    ASSERT_EQ((DynamicArray<double>{3.0, 6.0, 11.0}), shifted);
+}
+
+TEST(CompressedIntArrayTest, SortedColumn) {
+    DynamicArray<int> steps;
+    initializeWithRandNumbers(steps, 10 * size + 7, 0, 20);
+
+    DynamicArray<int64_t> da;
+    int64_t val = -1'000'000'000'000;
+    for (size_t p = 0; p < steps.size(); ++p) {
+        val += steps[p] + 10;
+        da.push_back(val);
+    }
+
+    CompressedIntArray<int64_t> ca(da);
+    ASSERT_EQ(da.size(), ca.size());
+    ASSERT_LT(ca.bytes() * 8, da.size() * sizeof(int64_t));
+
+    size_t p = 0;
+    for (auto it = ca.cbegin(); it != ca.cend(); ++it, ++p) {
+        ASSERT_EQ(da[p], *it);
+    }
+    ASSERT_EQ(da.size(), p);
+
+    for (size_t key = 0; key < da.size(); key += 37) {
+        ASSERT_EQ(da[key], ca[key]);
+    }
+    ASSERT_EQ(da[da.size() - 1], ca.at(da.size() - 1));
+    ASSERT_ANY_THROW(ca.at(da.size()));
+    ASSERT_EQ(da, ca.decompress());
+}
+
+TEST(CompressedIntArrayTest, LowEntropyAndFullWidth) {
+    DynamicArray<int> small;
+    initializeWithRandNumbers(small, size, -8, 7);
+    DynamicArray<int32_t> da;
+    for (size_t p = 0; p < small.size(); ++p) {
+        da.push_back(small[p] + 100'000);
+    }
+
+    CompressedIntArray<int32_t> ca(da);
+    ASSERT_LT(ca.bytes() * 4, da.size() * sizeof(int32_t));
+    ASSERT_EQ(da, ca.decompress());
+
+    int32_t block[CompressedIntArray<int32_t>::blockSize];
+    size_t n = ca.decodeBlock(ca.blocks() - 1, block);
+    ASSERT_EQ(size % CompressedIntArray<int32_t>::blockSize, n);
+    for (size_t p = 0; p < n; ++p) {
+        ASSERT_EQ(da[size - n + p], block[p]);
+    }
+
+    DynamicArray<int64_t> extremes{INT64_MIN, INT64_MAX, 0, -1, INT64_MAX, INT64_MIN, 1};
+    CompressedIntArray<int64_t> ce(extremes);
+    ASSERT_EQ(extremes, ce.decompress());
+    for (size_t p = 0; p < extremes.size(); ++p) {
+        ASSERT_EQ(extremes[p], ce[p]);
+    }
+
+    CompressedIntArray<int64_t> empty{DynamicArray<int64_t>()};
+    ASSERT_TRUE(empty.empty());
+    ASSERT_TRUE(empty.cbegin() == empty.cend());
+}
+
+TEST(SparseDynamicArrayTest, LazyPages) {
+    const size_t bigSize = 1'000 * size;
+    SparseDynamicArray<int, 256> sa(bigSize, -1);
+    ASSERT_EQ(bigSize, sa.size());
+    ASSERT_EQ(0, sa.allocatedPages());
+
+    const SparseDynamicArray<int, 256>& csa = sa;
+    for (size_t p = 0; p < bigSize; p += 997) {
+        ASSERT_EQ(-1, csa[p]);
+    }
+    ASSERT_EQ(0, sa.allocatedPages());
+
+    std::map<size_t, int> sample;
+    DynamicArray<int> positions;
+    initializeWithRandNumbers(positions, size / 10, 0, 2 * size);
+    for (size_t p = 0; p < positions.size(); ++p) {
+        size_t key = static_cast<size_t>(positions[p] + static_cast<int>(size)) * 97 + 1;
+        sa.set(key, static_cast<int>(p));
+        sample[key] = static_cast<int>(p);
+    }
+    ASSERT_LE(sa.allocatedPages(), positions.size());
+    ASSERT_TRUE(sa.isAllocated(sample.begin()->first));
+
+    for (const auto& kv : sample) {
+        ASSERT_EQ(kv.second, sa.get(kv.first));
+        ASSERT_EQ(kv.second, sa.at(kv.first));
+    }
+    ASSERT_ANY_THROW(csa.at(bigSize));
+
+    SparseDynamicArray<int, 256> copy(sa);
+    copy[0] = 5;
+    ASSERT_EQ(sa.allocatedPages() + (sa.isAllocated(0) ? 0 : 1), copy.allocatedPages());
+    ASSERT_EQ(-1, csa[0]);
+}
+
+TEST(SparseDynamicArrayTest, ProxyReadsDoNotAllocate) {
+    SparseDynamicArray<int, 256> sa(size, 7);
+
+    int x = sa[10];
+    const int& y = sa.at(20);
+    ASSERT_EQ(7, x);
+    ASSERT_EQ(7, y);
+    ASSERT_EQ(0, sa.allocatedPages());
+
+    sa[300] = 1;
+    ASSERT_EQ(1, sa.allocatedPages());
+    sa[600] = sa[300];
+    sa[601] = sa[10];
+    ASSERT_EQ(2, sa.allocatedPages());
+    ASSERT_EQ(1, sa.get(600));
+    ASSERT_EQ(7, sa.get(601));
+
+    sa.touch(900) += 5;
+    ASSERT_EQ(12, sa.get(900));
+    ASSERT_EQ(3, sa.allocatedPages());
+}
+
+TEST(SparseDynamicArrayTest, MovedFromKeepsDefault) {
+    SparseDynamicArray<std::string, 4> sa(10, "d");
+    sa[1] = "a";
+
+    SparseDynamicArray<std::string, 4> moved(std::move(sa));
+    ASSERT_EQ("a", moved.get(1));
+    ASSERT_EQ("d", moved.get(2));
+
+    sa.resize(5);
+    ASSERT_EQ("d", sa.get(3));
+    ASSERT_EQ("d", sa.defaultValue());
+}
+
+TEST(SparseDynamicArrayTest, ResizeCompact) {
+    SparseDynamicArray<std::string, 4> sa(10, "x");
+    sa[1] = "a";
+    sa[9] = "b";
+    ASSERT_EQ(2, sa.allocatedPages());
+
+    sa.resize(6);
+    ASSERT_EQ(1, sa.allocatedPages());
+    sa[5] = "c";
+    sa.resize(3);
+    sa.resize(7);
+    for (size_t p = 3; p < 7; ++p) {
+        ASSERT_EQ("x", sa.get(p));
+    }
+
+    DynamicArray<std::string> dense = sa.compact();
+    ASSERT_EQ((DynamicArray<std::string>{"x", "a", "x", "x", "x", "x", "x"}), dense);
+
+    sa.releasePage(0);
+    ASSERT_EQ("x", sa.get(1));
+    sa.clear();
+    ASSERT_TRUE(sa.empty());
+    ASSERT_EQ(0, sa.pages());
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);